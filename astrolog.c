@@ -186,6 +186,9 @@ void Action()
   if (us.fWriteFile)        /* If -o switch in effect, then write */
     FOutputData();          /* the chart information to a file.   */
 
+  if (us.fCalcStats)        /* If -YV switch in effect, then show how */
+    PrintCalcStats();       /* much work went into making the charts. */
+
 LDone:
   if (is.S != stdout) /* If we were internally directing chart display to a */
     fclose(is.S);     /* file as with the -os switch, close it here.        */
@@ -383,6 +386,14 @@ byte **argv;
     SwitchF(oscLilith);
     break;
 
+  case 'V':
+    SwitchF(us.fCalcStats);
+    break;
+
+  case 'e':
+    SwitchF(us.fEventRefine);
+    break;
+
   case '8':
     SwitchF(us.fClip80);
     break;
@@ -492,6 +503,108 @@ byte **argv;
     break;
 #endif
 
+#ifdef PLACALC
+  case 'f':
+    if (argc <= 1) {
+      ErrorArgc("Yf");
+      return tcError;
+    }
+    r = atof(argv[1]);
+    if (r < 0.0) {
+      ErrorValR("Yf", r);
+      return tcError;
+    }
+    us.rChebError = r;
+    darg++;
+    break;
+
+  case 's':
+    if (argc <= 1) {
+      ErrorArgc("Ys");
+      return tcError;
+    }
+    i = atoi(argv[1]);
+    if (!FBetween(i, 0, 16)) {
+      ErrorValN("Ys", i);
+      return tcError;
+    }
+    us.nSegCache = i;
+    darg++;
+    break;
+
+  case 'u':
+    if (argc <= 1) {
+      ErrorArgc("Yu");
+      return tcError;
+    }
+    r = atof(argv[1]);
+    if (r < 0.0) {
+      ErrorValR("Yu", r);
+      return tcError;
+    }
+    us.rNutError = r;
+    darg++;
+    break;
+
+  case 'a':
+    if (argc <= 1) {
+      ErrorArgc("Ya");
+      return tcError;
+    }
+    r = atof(argv[1]);
+    if (r < 0.0) {
+      ErrorValR("Ya", r);
+      return tcError;
+    }
+    us.rEphTier = r;
+    darg++;
+    break;
+
+  case 'p':
+    if (us.fNoWrite) {
+      ErrorArgv("Yp");
+      return tcError;
+    }
+    if (argc <= 3) {
+      ErrorArgc("Yp");
+      return tcError;
+    }
+    i = NParseSz(argv[2], pmYea);
+    j = NParseSz(argv[3], pmYea);
+    if (!FValidYea(i)) {
+      ErrorValN("Yp", i);
+      return tcError;
+    } else if (!FValidYea(j) || j < i) {
+      ErrorValN("Yp", j);
+      return tcError;
+    }
+    if (!FWritePack(argv[1], i, j))
+      return tcError;
+
+    /* Writing the pack is the whole run, so don't go on to display a  */
+    /* chart. In the -Q loop, skip straight to prompting for the next. */
+
+    if (!us.fLoop)
+      Terminate(tcOK);
+    return tcError;
+#endif
+
+#ifdef FORK
+  case 'w':
+    if (argc <= 1) {
+      ErrorArgc("Yw");
+      return tcError;
+    }
+    i = atoi(argv[1]);
+    if (i < 1) {
+      ErrorValN("Yw", i);
+      return tcError;
+    }
+    us.nSearchProc = i;
+    darg++;
+    break;
+#endif
+
   case 'b':
     if (argc <= 1) {
       ErrorArgc("Yb");
@@ -523,6 +636,7 @@ byte **argv;
     oe.an0 = atof(argv[12]); oe.an1 = atof(argv[13]); oe.an2 = atof(argv[14]);
     oe.ma0 = atof(argv[15]); oe.ma1 = atof(argv[16]); oe.ma2 = atof(argv[17]);
     rgoe[IoeFromObj(i)] = oe;
+    InvalidateCast();
     darg += 17;
     break;
 
@@ -592,6 +706,7 @@ byte **argv;
       (ch1 == 'd' ? rObjAdd : rAspAngle));
     for (k = i; k <= j; k++)
       lpr[k] = atof(argv[3+k-i]);
+    InvalidateOrbs();
     darg += 3+j-i;
     break;
 
@@ -823,6 +938,7 @@ byte **argv;
          return tcError;
       }
       StarOrb = r;
+      InvalidateOrbs();
       darg++;
       break;
     }
@@ -903,6 +1019,7 @@ byte **argv;
          return tcError;
       }
       CoeffComp = r;
+      InvalidateOrbs();
       darg++;
       break;
     }
@@ -913,6 +1030,7 @@ byte **argv;
          return tcError;
       }
       CoeffPar = r;
+      InvalidateOrbs();
       darg++;
       break;
     }
@@ -1055,6 +1173,8 @@ byte **argv;
     case 'v':
       if (ch1 == '0')
         SwitchF(us.fVelocity);
+      else if (ch1 == 'h')
+        SwitchF(us.fHouseSystems);
       SwitchF(us.fListing);
       break;
 
@@ -1154,6 +1274,8 @@ byte **argv;
     case 'L':
       if (ch1 == '0')
         SwitchF(us.fLatitudeCross);
+      else if (ch1 == 'h')
+        SwitchF(us.fHouseGrid);
       if (argc > 1 && (i = atoi(argv[1]))) {
         argc--; argv++;
         if (!FValidAstrograph(i)) {
@@ -1689,6 +1811,7 @@ byte **argv;
             return fFalse;
           } else {
             rAspOrb[i] = -rDegHalf;
+            InvalidateOrbs();
             argc--; argv++;
           }
         break;
@@ -1799,6 +1922,7 @@ byte **argv;
             rObjAdd[i] = rT;
           else
             rAspAngle[i] = rT;
+          InvalidateOrbs();
         }
         argc -= 2; argv += 2;
       }
@@ -1807,6 +1931,36 @@ byte **argv;
     /* Switches which affect how a chart is computed: */
 
     case 'b':
+#ifdef PLACALC
+      if (ch1 == 'p') {
+        if (fAnd) {
+          us.szEphPack = NULL;
+          break;
+        }
+        if (argc <= 1) {
+          ErrorArgc("bp");
+          return fFalse;
+        }
+        us.szEphPack = SzPersist(argv[1]);
+        us.fPlacalc = fTrue;
+        argc--; argv++;
+        break;
+      }
+      if (ch1 == 'j') {
+        if (fAnd) {
+          us.szEphJPL = NULL;
+          break;
+        }
+        if (argc <= 1) {
+          ErrorArgc("bj");
+          return fFalse;
+        }
+        us.szEphJPL = SzPersist(argv[1]);
+        us.fPlacalc = fTrue;
+        argc--; argv++;
+        break;
+      }
+#endif
       if (ch1 == '0')
         SwitchF(us.fSeconds);
       else if (ch1 == 'a')
@@ -85,6 +85,10 @@
 #define ENVIRON /* Comment out this #define if your system doesn't have  */
                 /* environment variables or can't compile calls to them. */
 
+#define FORK /* Comment out this #define if your system doesn't have Unix */
+             /* style 'fork' and 'wait' calls, as used by -Yw to split   */
+             /* long transit searches among several processes.           */
+
 /*#define ATOF /* Comment out this #define if you have a system in which  */
              /* 'atof' and related functions aren't defined in stdio.h, */
              /* such as most PC's, Linux, VMS compilers, and NeXT's.    */
@@ -287,6 +291,10 @@
 #ifdef TIME
 #include <time.h>
 #endif
+#ifdef FORK
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 #ifdef X11
 #define ISG
@@ -340,8 +348,17 @@
 #ifdef ENVIRON
 "If 'MAC' is defined 'ENVIRON' must not be as well"
 #endif
+#ifdef FORK
+"If 'MAC' is defined 'FORK' must not be as well"
+#endif
 #endif /* MAC */
 
+#ifdef PC
+#ifdef FORK
+"If 'PC' is defined 'FORK' must not be as well"
+#endif
+#endif /* PC */
+
 #ifdef X11
 #ifndef GRAPH
 "If 'X11' is defined 'GRAPH' must be too"
@@ -517,6 +534,7 @@
 #define rSmall     (1.7453E-09)
 #define rLarge     10000.0
 #define rRound     0.5
+#define rEventPrec (1.0/86400.0)
 
 #define chNull     '\0'
 #define chEscape   '\33'
@@ -543,6 +561,9 @@
 #define cAspConfig 8
 #define cWeek      7
 #define cColor     16
+#define cFileCache 16
+#define cSearchProc 64
+#define cCalcStat 21
 #define xFont      6
 #define yFont      10
 #define xFontT     (xFont*gi.nScaleT)
@@ -774,6 +795,20 @@
 #define mfRight  0x02
 #define mfMiddle 0x04
 
+/* Event refinement kinds */
+
+#define evLon   0
+#define evSpeed 1
+
+/* Time span in centuries from 2000 over which rMatrixErr holds, see -Ya. */
+
+#define rMatrixSpan 2.0
+#define rMatrixTrueNode 1138.0
+
+/* Margin added to aspect sweep windows, to cover rounding in the tests. */
+
+#define rSweepSlack 1.0E-6
+
 /* Termination codes */
 
 #define tcError -1
@@ -1085,6 +1120,13 @@ typedef struct _GridInfo {
   short v[objMax][objMax];
 } GridInfo;
 
+typedef struct _SweepInfo {
+  real lon;  /* Zodiac longitude the objects are sorted by.    */
+  real rad;  /* Extra width of aspect windows about the object. */
+  real cap;  /* Limit on the orbs of aspects to the object.     */
+  int obj;   /* Object index.                                  */
+} SweepInfo;
+
 typedef struct _CrossInfo {
   real lat[MAXCROSS];
   real lon[MAXCROSS];
@@ -1119,6 +1161,7 @@ typedef struct _UserSettings {
 
   /* Chart suboptions */
   _bool fVelocity;      /* -v0 */
+  _bool fHouseSystems;  /* -vh */
   _bool fWheelReverse;  /* -w0 */
   _bool fGridConfig;    /* -g0 */
   _bool fAppSep;        /* -ga */
@@ -1131,6 +1174,7 @@ typedef struct _UserSettings {
   _bool fSectorApprox;  /* -l0 */
   _bool fInfluenceSign; /* -j0 */
   _bool fLatitudeCross; /* -L0 */
+  _bool fHouseGrid;     /* -Lh */
   _bool fCalendarYear;  /* -Ky */
   _bool fInDayMonth;    /* -dm */
   _bool fArabicFlip;    /* -P0 */
@@ -1188,6 +1232,8 @@ typedef struct _UserSettings {
   _bool fNoRead;      /* -0i */
   _bool fNoQuit;      /* -0q */
   _bool fNoGraphics;  /* -0X */
+  _bool fCalcStats;   /* -YV */
+  _bool fEventRefine; /* -Ye */
 
   /* Value settings */
   int   nEphemYears;  /* -Ey */
@@ -1220,6 +1266,13 @@ typedef struct _UserSettings {
   long  lTimeAddition;   /* -Yz */
   int   nArabicNight;    /* -YP */
   int   nBioday;         /* -Yb */
+  int   nSearchProc;     /* -Yw */
+  real  rChebError;      /* -Yf */
+  int   nSegCache;       /* -Ys */
+  real  rNutError;       /* -Yu */
+  real  rEphTier;        /* -Ya */
+  byte *szEphPack;       /* -bp */
+  byte *szEphJPL;        /* -bj */
 } US;
 
 typedef struct _InternalSettings {
@@ -1231,6 +1284,9 @@ typedef struct _InternalSettings {
   _bool fSzPersist;   /* Are parameter strings persistent when processing? */
   _bool fSzInteract;  /* Are we in middle of chart so some setting fixed?  */
   _bool fNoEphFile;   /* Have we already had a ephem file not found error? */
+  _bool fNoHouse;     /* Can chart casts skip houses, as a search needs none? */
+  _bool fNoStar;      /* Can chart casts skip the stars for the same reason?  */
+  _bool fCoarse;      /* Do chart casts only bracket times refined later?     */
   char *szProgName;   /* The name and path of the executable running.      */
   char *szFileScreen; /* The file to send text output to as passed to -os. */
   char *szFileOut;    /* The output chart filename string as passed to -o. */
@@ -1247,6 +1303,15 @@ typedef struct _InternalSettings {
   real Asc; /* Ascendant at chart time. */
   real RA;  /* Right ascension at time. */
   real OB;  /* Obliquity of ecliptic.   */
+  long cCastFull;    /* Number of full chart casts, for -YV.      */
+  long cCastLight;   /* Casts skipping houses or stars, for -YV.  */
+  long cEventRefine; /* Number of event times refined, for -YV.  */
+  long cEventCalc;   /* Ephemeris calls made refining the events. */
+  long cTierMatrix;  /* Positions left to Matrix formulas by -Ya. */
+  long cSweepAll;    /* Object pairs an aspect sweep looked over.  */
+  long cSweepHit;    /* Pairs found within the sweep's windows.    */
+  long lOrbVer;      /* Bumped when orb settings change.           */
+  long rglStatFork[cCalcStat]; /* -YV counts made by forked processes. */
 } IS;
 
 typedef struct _ChartInfo {
@@ -1271,6 +1336,67 @@ typedef struct _ChartPositions {
   byte house[objMax]; /* House each object is in. */
 } CP;
 
+typedef struct _HouseInfo {
+  real MC;              /* Midheaven at the location.    */
+  real Asc;             /* Ascendant at the location.    */
+  real cusp[cSign+1];   /* House cusps at the location. */
+} HI;
+
+typedef struct _HouseTrig {
+  _bool fSet;             /* Have the terms below been computed.       */
+  real OB;                /* Obliquity, latitude, and right ascension  */
+  real lat;               /* the terms were computed for.              */
+  real RA;
+  real CosOB;             /* Terms of the obliquity.                   */
+  real SinOB;
+  real TanOB;
+  real CosAA;             /* Terms of the latitude, the last nudged    */
+  real TanAA;             /* off the equator for Placidus.             */
+  real TanAA0;
+  _bool fRA;              /* Have the right ascension terms been set.  */
+  real rgCosRA[cSign+1];  /* Terms of the right ascension plus each    */
+  real rgSinRA[cSign+1];  /* house's offset from it.                   */
+} HT;
+
+typedef struct _FileCache {
+  int cfile;                          /* Number of file names in cache.  */
+  byte szEnv[3][cchSzMax];            /* Environment cache is valid for. */
+  byte szFile[cFileCache][cchSzDef];  /* File names searched for.        */
+  byte szPath[cFileCache][cchSzMax];  /* Where each file was found.      */
+  int nMode[cFileCache];              /* FileOpen() mode, or -1.         */
+  long cHit;                          /* Lookups answered from cache.    */
+  long cMiss;                         /* Lookups searching directories.  */
+} FC;
+
+typedef struct _CastCache {
+  _bool fPlanet;             /* Are the planet positions below saved.   */
+  US usPlanet;               /* Settings the planets were cast under.   */
+  real TPlanet;              /* Julian time the planets were cast for.  */
+  real rSidPlanet;           /* Sidereal offset they were cast with.    */
+  byte ignore[oNorm+1];      /* Objects restricted when they were cast. */
+  _bool fCoarse;             /* Was -Ya allowed to tier the positions.  */
+  byte forceSN;              /* Was the South Node placed by the North. */
+  real obj[oNorm+1];         /* Planet positions, latitudes, speeds.    */
+  real alt[oNorm+1];
+  real dir[oNorm+1];
+  real altdir[oNorm+1];
+  _bool fAltDir[oNorm+1];    /* Which latitude speeds the cast set.     */
+  real spacex[oNorm+1];      /* Rectangular coordinates of planets.     */
+  real spacey[oNorm+1];
+  real spacez[oNorm+1];
+  _bool fStar;               /* Are the star positions below saved.     */
+  US usStar;                 /* Settings the stars were cast under.     */
+  real TStar;                /* Julian time the stars were cast for.    */
+  real rSidStar;             /* Sidereal offset they were cast with.    */
+  real SD;                   /* Precession offset they were cast with.  */
+  real objStar[cStar+1];     /* Star positions, latitudes, speeds.      */
+  real altStar[cStar+1];
+  real dirStar[cStar+1];
+  int starname[cStar+1];     /* Order the stars were sorted into.       */
+  long cReusePlanet;         /* Casts reusing saved planets, for -YV.   */
+  long cReuseStar;           /* Casts reusing saved stars, for -YV.     */
+} CAC;
+
 #ifdef GRAPH
 typedef struct _GraphicsSettings {
   _bool fBitmap;    /* Are we creating a bitmap file (-Xb set).         */
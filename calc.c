@@ -37,6 +37,7 @@
 */
 
 #include "astrolog.h"
+#include <string.h>
 
 real ObjPrime[oNorm+1];
 real StarPrime[cStar+1];
@@ -126,13 +127,14 @@ void HouseAlcabitius()
   real rDecl, rSda, rSna, r, hr, hr2;
   int i;
 
+  ComputeHouseTrig();
   if (hRevers) {
     is.Asc = Mod(is.Asc - rDegHalf);
     hRevers = 2;
   }
 
-  rDecl = RAsin(RSin(is.OB) * RSinD(is.Asc));
-  r = -RTan(AA) * RTan(rDecl);
+  rDecl = RAsin(ht.SinOB * RSinD(is.Asc));
+  r = -ht.TanAA * RTan(rDecl);
   rSda = DFromR(RAcos(r));
   rSna = rDegHalf - rSda;
   chouse[sLib] = DFromR(is.RA) - rSna;
@@ -144,7 +146,7 @@ void HouseAlcabitius()
 
   for (i = sLib; i <= sPis; i++) {
     hr = RFromD(chouse[i]);
-    hr2 = RAtn(RTan(hr)/RCos(is.OB));
+    hr2 = RAtn(RTan(hr)/ht.CosOB);
     if (hr2 < 0.0)
       hr2 += rPi;
     if (RSin(hr) < 0.0)
@@ -265,7 +267,16 @@ int housesystem;
     PrintWarning(sz);
     AA = RSgn2(AA)*RFromD(rDegQuad-rAxis);
   }
+  ComputeHouseCusps(housesystem);
+}
+
+
+/* This is a subprocedure of ComputeHouses(). Calculate the house cusps */
+/* in the given system, once the latitude is known to be valid for it.  */
 
+void ComputeHouseCusps(housesystem)
+int housesystem;
+{
   /* Flip the Ascendant if it falls in the wrong half of the zodiac. */
   if (MinDifference(is.MC, is.Asc) < 0.0 && housesystem == 13)
     is.Asc = Mod(is.Asc + rDegHalf);
@@ -290,6 +301,49 @@ int housesystem;
 }
 
 
+/* Calculate the house cusps of the current chart in every house system,  */
+/* storing each system's cusps in the table along with the Ascendant and */
+/* Midheaven it leaves, as some systems flip them at polar latitudes. The */
+/* chart's time and location are processed once and shared by all the    */
+/* systems, with the latitude clamped for Placidus and Koch at extreme    */
+/* latitudes (which is done without warning). This is used by the -vh    */
+/* chart. The current cusps and angles are unchanged.                     */
+
+void ComputeHousesAll(rghi)
+HI *rghi;
+{
+  CI ciT;
+  real rgcusp[cSign+1], MCT = is.MC, AscT = is.Asc, RAT = is.RA,
+    AAT, MC, Asc, vtx;
+  int hReversT = hRevers, hRev, sys, i;
+
+  for (i = 1; i <= cSign; i++)
+    rgcusp[i] = chouse[i];
+  ciT = ciCore;
+  ProcessInput(fFalse);
+  ComputeVariables(&vtx);
+  if (us.fGeodetic)
+    is.RA = RFromD(Mod(-OO));
+  MC = CuspMidheaven();
+  Asc = CuspAscendant();
+  hRev = RAbs(AA) > RFromD(rDegQuad - rAxis) && Mod(Asc - MC) > rDegHalf;
+  AAT = AA;
+  for (sys = cSystem-1; sys >= 0; sys--) {
+    AA = AAT; is.MC = MC; is.Asc = Asc; hRevers = hRev;
+    if (RAbs(AA) > RFromD(rDegQuad-rAxis) && sys < 2)
+      AA = RSgn2(AA)*RFromD(rDegQuad-rAxis);
+    ComputeHouseCusps(sys);
+    rghi[sys].MC = is.MC; rghi[sys].Asc = is.Asc;
+    for (i = 1; i <= cSign; i++)
+      rghi[sys].cusp[i] = chouse[i];
+  }
+  for (i = 1; i <= cSign; i++)
+    chouse[i] = rgcusp[i];
+  ciCore = ciT;
+  is.MC = MCT; is.Asc = AscT; is.RA = RAT; hRevers = hReversT;
+}
+
+
 /*
 ******************************************************************************
 ** Star Position Calculations.
@@ -516,6 +570,38 @@ real r, azi, alt, *rx, *ry, *rz;
 
 
 #ifdef PLACALC
+/* Return whether an object of the chart being cast may be left to the */
+/* Matrix formulas even though -b is in effect. This is so when -Ya is */
+/* in effect, the chart only brackets times which are refined with -b  */
+/* afterward (or is an animation frame), and the formulas are known to */
+/* be within the -Ya error for the object around the chart's time.     */
+
+bool FMatrixTier(obj)
+int obj;
+{
+  real r;
+
+  if (!is.fCoarse || us.rEphTier <= 0.0 || us.objCenter != oEar ||
+    obj >= uranHi || RAbs(is.T - 1.0) > rMatrixSpan)
+    return fFalse;
+  r = obj == oNod && us.fTrueNode ? rMatrixTrueNode : rMatrixErr[obj];
+  return r > 0.0 && r <= us.rEphTier;
+}
+
+
+/* Return the largest error in seconds of arc an object's position may    */
+/* have in the chart being cast, i.e. its Matrix error if FMatrixTier() */
+/* left it to the Matrix formulas, and otherwise zero.                  */
+
+real RMatrixTierErr(obj)
+int obj;
+{
+  if (!FMatrixTier(obj))
+    return 0.0;
+  return obj == oNod && us.fTrueNode ? rMatrixTrueNode : rMatrixErr[obj];
+}
+
+
 /* Compute the positions of the planets at a certain time using the Placalc */
 /* accurate formulas and ephemeris. This will supersede the Matrix routine  */
 /* values and is only called with the -b switch is in effect. Not all       */
@@ -539,6 +625,18 @@ real t;
   for (i = oSun; i < uranHi; i++) {
     if ((ignore[i] && i > oMoo) || FBetween(i, oFor, cuspHi))
       continue;
+
+    /* Objects -Ya allows the Matrix formulas for keep their positions, */
+    /* with the velocities the formulas assume for the Moon and Node.   */
+
+    if (FMatrixTier(i)) {
+      if (i == oMoo)
+        ret[i] = RFromD(12.5);
+      else if (i == oNod)
+        ret[i] = RFromD(-0.053);
+      is.cTierMatrix++;
+      continue;
+    }
     if (FPlacalcPlanet(i, t*36525.0+2415020.0, us.objCenter != oEar,
       &r1, &r2, &r3, &r4, &r5)) {
 
@@ -589,9 +687,262 @@ real t;
   spacex[us.objCenter] = spacey[us.objCenter] = spacez[us.objCenter] =
     planet[us.objCenter] = planetalt[us.objCenter] = ret[us.objCenter] = 0.0;
 }
+
+
+/* Return whether the times of events found by the -d and -t searches can */
+/* be refined by computing object positions directly from the ephemeris. */
+/* This can be done when the chart positions are just the ephemeris ones, */
+/* i.e. when no switch is in effect transforming them after they're cast. */
+
+bool FEventRefine()
+{
+  return us.fEventRefine && us.fPlacalc && us.objCenter == oEar &&
+    !us.fProgress && !us.fEquator && !us.fParallel && us.nHarmonic <= 1 &&
+    !us.fDecan && !us.fNavamsa && !us.fFlip;
+}
+
+
+/* Return the value for an event at a moment, which crosses zero at the   */
+/* exact time of the event. For longitude events this is the difference  */
+/* between the positions of two objects (or of one object and the zodiac  */
+/* start if the second is negative) less an offset, and for speed events */
+/* it's the velocity of the first object. Clear the flag if the ephemeris */
+/* can't compute the objects.                                            */
+
+real REventValue(nEvent, obj1, obj2, rOff, jd, pf)
+int nEvent, obj1, obj2;
+real rOff, jd;
+bool *pf;
+{
+  real r1, r2, r3, r4, r5, lon;
+
+  if (force[obj1] != 0.0 || (obj2 >= 0 && force[obj2] != 0.0) ||
+    !FPlacalcPlanet(obj1, jd, fFalse, &r1, &r2, &r3, &r4, &r5)) {
+    *pf = fFalse;
+    return 0.0;
+  }
+  is.cEventCalc++;
+  if (nEvent == evSpeed)
+    return r3;
+  lon = r1 - rOff;
+  if (obj2 >= 0) {
+    if (!FPlacalcPlanet(obj2, jd, fFalse, &r1, &r2, &r3, &r4, &r5)) {
+      *pf = fFalse;
+      return 0.0;
+    }
+    is.cEventCalc++;
+    lon -= r1;
+  }
+  lon = Mod(lon);
+  return lon > rDegHalf ? lon - rDegMax : lon;
+}
+
+
+/* Find the exact time of an event known to happen between two Julian    */
+/* days, iterating on the ephemeris positions rather than interpolating  */
+/* between the positions at each end. This is the Illinois variation of  */
+/* the false position method, which converges fast but never leaves the  */
+/* bracketing interval. Return false if the event can't be refined, e.g. */
+/* the objects involved aren't ephemeris bodies or the values at the two */
+/* ends don't bracket a zero, in which case the caller's time should do. */
+/* Charts cast with -Ya may be off by up to the Matrix error of the two  */
+/* objects, so they can find an event that's really in a step before or  */
+/* after the interval, especially near a station. While the end nearer  */
+/* the event is within that error, the interval is moved a step further */
+/* that way, until it brackets the event to solve as usual.             */
+
+bool FRefineEvent(nEvent, obj1, obj2, rOff, jd1, jd2, pjd)
+int nEvent, obj1, obj2;
+real rOff, jd1, jd2, *pjd;
+{
+  real f1, f2, f, jd, rErr;
+  int i, nSide = 0;
+  bool fOk = fTrue;
+
+  f1 = REventValue(nEvent, obj1, obj2, rOff, jd1, &fOk);
+  f2 = REventValue(nEvent, obj1, obj2, rOff, jd2, &fOk);
+  if (!fOk ||
+    (nEvent == evLon && (RAbs(f1) > rDegQuad || RAbs(f2) > rDegQuad)))
+    return fFalse;
+  if ((f1 < 0.0) == (f2 < 0.0)) {
+    rErr = (RMatrixTierErr(obj1) +
+      (obj2 >= 0 ? RMatrixTierErr(obj2) : 0.0)) / 3600.0;
+    if (rErr <= 0.0)
+      return fFalse;
+    jd = jd2 - jd1;
+    nSide = RAbs(f1) < RAbs(f2) ? -1 : 1;
+    for (i = 0; (f1 < 0.0) == (f2 < 0.0); i++) {
+      if (i >= 100 || (nEvent == evLon && RAbs(nSide < 0 ? f1 : f2) > rErr))
+        return fFalse;
+      if (nSide < 0) {
+        jd2 = jd1; f2 = f1;
+        jd1 -= jd;
+        f1 = f = REventValue(nEvent, obj1, obj2, rOff, jd1, &fOk);
+      } else {
+        jd1 = jd2; f1 = f2;
+        jd2 += jd;
+        f2 = f = REventValue(nEvent, obj1, obj2, rOff, jd2, &fOk);
+      }
+
+      /* There's no known error for the Matrix velocities, so just keep */
+      /* going for a station as long as the speed heads toward zero.    */
+
+      if (!fOk || (nEvent == evLon && RAbs(f) > rDegQuad) ||
+        (nEvent == evSpeed && (f1 < 0.0) == (f2 < 0.0) &&
+        RAbs(f) >= RAbs(nSide < 0 ? f2 : f1)))
+        return fFalse;
+    }
+    nSide = 0;
+  }
+  jd = jd1;
+  for (i = 0; i < 50 && jd2 - jd1 > rEventPrec; i++) {
+    jd = jd1 + f1 / (f1 - f2) * (jd2 - jd1);
+    f = REventValue(nEvent, obj1, obj2, rOff, jd, &fOk);
+    if (f == 0.0)
+      break;
+    if ((f < 0.0) == (f1 < 0.0)) {
+      jd1 = jd; f1 = f;
+      if (nSide < 0)
+        f2 /= 2.0;
+      nSide = -1;
+    } else {
+      jd2 = jd; f2 = f;
+      if (nSide > 0)
+        f1 /= 2.0;
+      nSide = 1;
+    }
+  }
+  *pjd = jd;
+  is.cEventRefine++;
+  return fTrue;
+}
+
+
+/* Like FRefineEvent() for the time an object makes an aspect to another  */
+/* object, or to a fixed position given by the offset if the second is   */
+/* negative. The aspect could be in either direction so try both.        */
+
+bool FRefineAspect(obj1, obj2, rOff, asp, jd1, jd2, pjd)
+int obj1, obj2, asp;
+real rOff, jd1, jd2, *pjd;
+{
+  return FRefineEvent(evLon, obj1, obj2, rOff + rAspAngle[asp],
+    jd1, jd2, pjd) || FRefineEvent(evLon, obj1, obj2, rOff - rAspAngle[asp],
+    jd1, jd2, pjd);
+}
 #endif
 
 
+/* The last chart cast keeps its planet and star positions, along with    */
+/* the inputs they depend on, so a chart cast again for the same moment  */
+/* (e.g. one only relocated) can reuse them and just redo the houses.    */
+
+CAC cac;
+
+
+/* Compute the positions of the planets, Moon, and Nodes for the current */
+/* chart time, or restore them from the last cast if nothing they depend */
+/* on has changed since. This is the part of CastChart() independent of  */
+/* the chart's location.                                                 */
+
+void CastPlanets()
+{
+  real rgAlt[oNorm+1];
+  int i;
+
+  if (cac.fPlanet && cac.TPlanet == is.T && cac.rSidPlanet == is.rSid &&
+    cac.fCoarse == is.fCoarse && cac.forceSN == forceSN &&
+    memcmp(cac.ignore, ignore, sizeof(cac.ignore)) == 0 &&
+    memcmp(&cac.usPlanet, &us, sizeof(US)) == 0) {
+    for (i = 0; i <= oNorm; i++) {
+      planet[i] = cac.obj[i]; planetalt[i] = cac.alt[i]; ret[i] = cac.dir[i];
+      if (cac.fAltDir[i])
+        altret[i] = cac.altdir[i];
+      spacex[i] = cac.spacex[i]; spacey[i] = cac.spacey[i];
+      spacez[i] = cac.spacez[i];
+    }
+    cac.cReusePlanet++;
+    return;
+  }
+
+  /* Mark the latitude speeds so the ones the ephemeris sets are known. */
+
+  for (i = 0; i <= oNorm; i++) {
+    rgAlt[i] = altret[i];
+    altret[i] = -rLarge;
+  }
+
+  /* Go calculate planet, Moon, and North Node positions. */
+
+  ComputePlanets();
+  if (!ignore[oMoo] || !ignore[oNod] || !ignore[oSou] || !ignore[oFor]) {
+    ComputeLunar(&planet[oMoo], &planetalt[oMoo],
+      &planet[oNod], &planetalt[oNod]);
+    ret[oNod] = -1.0;
+  }
+
+  /* Compute more accurate ephemeris positions for certain objects. */
+
+#ifdef PLACALC
+  if (us.fPlacalc)
+    ComputePlacalc(is.T);
+#endif
+  if (!us.fPlacalc || us.objCenter != oEar || forceSN) {
+    planet[oSou] = Mod(planet[oNod]+rDegHalf);
+    ret[oSou] = ret[oNod] = RFromD(-0.053);
+    ret[oMoo] = RFromD(12.5);
+  }
+
+  for (i = 0; i <= oNorm; i++) {
+    cac.fAltDir[i] = altret[i] != -rLarge;
+    if (!cac.fAltDir[i])
+      altret[i] = rgAlt[i];
+    cac.obj[i] = planet[i]; cac.alt[i] = planetalt[i]; cac.dir[i] = ret[i];
+    cac.altdir[i] = altret[i];
+    cac.spacex[i] = spacex[i]; cac.spacey[i] = spacey[i];
+    cac.spacez[i] = spacez[i];
+  }
+  memcpy(&cac.usPlanet, &us, sizeof(US));
+  memcpy(cac.ignore, ignore, sizeof(cac.ignore));
+  cac.TPlanet = is.T; cac.rSidPlanet = is.rSid;
+  cac.fCoarse = is.fCoarse; cac.forceSN = forceSN;
+  cac.fPlanet = fTrue;
+}
+
+
+/* Like CastPlanets() but for the fixed star positions, given the offset  */
+/* to add to them. Stars sorted by prime vertical depend on the chart's   */
+/* location, so they're always computed.                                  */
+
+void CastStars(SD)
+real SD;
+{
+  int i;
+
+  if (us.nStar != 'p' && PrimeRest <= 0 && cac.fStar && cac.TStar == is.T &&
+    cac.rSidStar == is.rSid && cac.SD == SD &&
+    memcmp(&cac.usStar, &us, sizeof(US)) == 0) {
+    for (i = 1; i <= cStar; i++) {
+      planet[oNorm+i] = cac.objStar[i]; planetalt[oNorm+i] = cac.altStar[i];
+      ret[oNorm+i] = cac.dirStar[i]; altret[oNorm+i] = 0.0;
+      starname[i] = cac.starname[i];
+    }
+    cac.cReuseStar++;
+    return;
+  }
+
+  ComputeStars(SD);
+  for (i = 1; i <= cStar; i++) {
+    cac.objStar[i] = planet[oNorm+i]; cac.altStar[i] = planetalt[oNorm+i];
+    cac.dirStar[i] = ret[oNorm+i];
+    cac.starname[i] = starname[i];
+  }
+  memcpy(&cac.usStar, &us, sizeof(US));
+  cac.TStar = is.T; cac.rSidStar = is.rSid; cac.SD = SD;
+  cac.fStar = fTrue;
+}
+
+
 /* This is probably the main routine in all of Astrolog. It generates a   */
 /* chart, calculating the positions of all the celestial bodies and house */
 /* cusps, based on the current chart information, and saves them for use  */
@@ -603,8 +954,9 @@ bool fDate;
   CI ci;
   real housetemp[cSign+1], Off = 0.0, vtx, j, l, m, ll, kk, alt1, alt2;
   real SunDirPos, SunDirection;
-  int i, k, n, ii, mi;
-  int ignoreT[objMax], ignoreT3[objMax];
+  int i, k, n, ii, mi, co, c, ic;
+  int ignoreT[objMax], ignoreT3[objMax], rgo[objMax], rgo2[objMax];
+  real rgOrb[cAspect+1], rgCap[objMax], rgAdd[objMax];
 
   /* Hack: Time zone +/-24 means to have the time of day be in Local Mean */
   /* Time (LMT). This is done by making the time zone value reflect the   */
@@ -651,6 +1003,10 @@ bool fDate;
 
   ci = ciCore;
   Longit = RealCoord(ciCore.lon); Latit = RealCoord(ciCore.lat);
+  if (is.fNoHouse || is.fNoStar)
+    is.cCastLight++;
+  else
+    is.cCastFull++;
 
   if (MM == -1) {
 
@@ -678,28 +1034,12 @@ bool fDate;
        }
     }
 
-    ComputeHouses(us.nHouseSystem); /* Go calculate house cusps. */
+    if (!is.fNoHouse)
+      ComputeHouses(us.nHouseSystem); /* Go calculate house cusps. */
 
     /* Go calculate planet, Moon, and North Node positions. */
 
-    ComputePlanets();
-    if (!ignore[oMoo] || !ignore[oNod] || !ignore[oSou] || !ignore[oFor]) {
-      ComputeLunar(&planet[oMoo], &planetalt[oMoo],
-        &planet[oNod], &planetalt[oNod]);
-      ret[oNod] = -1.0;
-    }
-
-    /* Compute more accurate ephemeris positions for certain objects. */
-
-#ifdef PLACALC
-    if (us.fPlacalc)
-      ComputePlacalc(is.T);
-#endif
-    if (!us.fPlacalc || us.objCenter != oEar || forceSN) {
-      planet[oSou] = Mod(planet[oNod]+rDegHalf);
-      ret[oSou] = ret[oNod] = RFromD(-0.053);
-      ret[oMoo] = RFromD(12.5);
-    }
+    CastPlanets();
 
     /* Calculate position of Part of Fortune. */
 
@@ -726,8 +1066,8 @@ bool fDate;
 
   /* Go calculate star positions if -U switch in effect. */
 
-  if (us.nStar)
-    ComputeStars(us.fSidereal ? 0.0 : -Off);
+  if (us.nStar && !is.fNoStar)
+    CastStars(us.fSidereal ? 0.0 : -Off);
 
   /* Transform ecliptic to equatorial coordinates if -sr in effect. */
 
@@ -758,18 +1098,30 @@ bool fDate;
 
   /* Alternative star restrictions - by ecliptic and prime vertical */
 
-  if (us.nStar) {
+  if (us.nStar && !is.fNoStar) {
     if (StarRest && !PrimeRest) {
       for (i = starLo; i <= starHi; i++)
         ignore[i] = 1;
+      EnsureOrbTab();
+
+      /* Only planets a sweep finds near some aspect to the star can */
+      /* bring it within orb, so the exact test skips all the rest. */
 
       if (!us.fParallel) {
+        co = 0;
+        for (k = 1; k <= uranHi; k++) if (!ignore[k])
+          rgo[co++] = k;
+        GetOrbBound(rgOrb, rgCap, rgAdd);
+        SetupSweep(planet, rgAdd, rgCap, rgo, co);
         for (i = starLo; i <= starHi; i++) {
-          for (k = 1; k <= uranHi; k++) if (!ignore[k]) {
+          c = CSweepAspect(planet[i], rgAdd[i], rgCap[i], rgOrb, StarAspects,
+            rgo2);
+          for (ic = 0; ic < c; ic++) {
+            k = rgo2[ic];
             for (n = 1; n <= StarAspects; n++) {
               l = MinDistance(planet[i], planet[k]);
               m = l - rAspAngle[n];
-              if (RAbs(m) < GetOrb(i,k,n))
+              if (RAbs(m) < OrbTab(i, k, n))
                  ignore [i] = 0;
             }
           }
@@ -782,11 +1134,11 @@ bool fDate;
             ll = RFromD(planet[i]); alt2 = RFromD(planetalt[i]);
             EclToEqu(&ll, &alt2); alt2 = DFromR(alt2);
             kk = RAbs(alt1 - alt2);
-            if (kk < GetOrb(i, k, aCon))
+            if (kk < OrbTab(i, k, aCon))
               ignore[i] = 0;
             else if (StarAspects > 1) {
               kk = RAbs(alt2) - RAbs(alt1);
-              if (RAbs(kk) < GetOrb(i, k, aCon))
+              if (RAbs(kk) < OrbTab(i, k, aCon))
                 ignore[i] = 0;
             }
           }
@@ -875,7 +1227,8 @@ bool fDate;
       planetalt[i] = ret[i] = 0.0;
     }
 
-  ComputeInHouses();        /* Figure out what house everything falls in. */
+  if (!is.fNoHouse)
+    ComputeInHouses();      /* Figure out what house everything falls in. */
 
   /* If -f domal chart switch in effect, switch planet and house positions. */
 
@@ -916,6 +1269,124 @@ bool fDate;
 }
 
 
+/* Compute the Midheaven, Ascendant, and house cusps of the current chart */
+/* at every location of a grid, for the chart's own time. The planets are */
+/* cast once, and all locations share the chart's sidereal time and      */
+/* obliquity, with the Midheaven computed once for each longitude.       */
+/* Longitudes are degrees west positive, latitudes degrees north, and the */
+/* results are stored row by row with one row for each latitude. Like the */
+/* transit searches, the rows are divided among processes if -Yw is set.  */
+/* The current chart is left as cast at its own location. This is used by */
+/* the -Lh chart.                                                          */
+
+int CastHouseGrid(rglon, clon, rglat, clat, rghi)
+real *rglon;
+int clon;
+real *rglat;
+int clat;
+HI *rghi;
+{
+  CI ciT;
+  CP cpT;
+  real rST, MC, MCT, AscT, RAT, vtx;
+  int hReversT, iproc, cproc = 1, ilat, ilat1, ilat2, ilon, i;
+  HI *phi;
+#ifdef FORK
+  FILE *rgfile[cSearchProc];
+  int k;
+#endif
+
+  CastChart(fTrue);
+  ciT = ciCore; cpT = cp0;
+  MCT = is.MC; AscT = is.Asc; RAT = is.RA; hReversT = hRevers;
+
+  /* Local sidereal time differs between locations only by longitude. */
+
+  ProcessInput(fFalse);
+  ComputeVariables(&vtx);
+  rST = DFromR(is.RA) + OO;
+
+#ifdef FORK
+  cproc = Min(Min(us.nSearchProc, cSearchProc), clat);
+  for (iproc = 0; iproc < cproc-1 && cproc > 1; iproc++)
+    if ((rgfile[iproc] = tmpfile()) == NULL) {
+      while (--iproc >= 0)
+        fclose(rgfile[iproc]);
+      cproc = 1;
+    }
+  fflush(NULL);
+#endif
+  for (iproc = 0; iproc < cproc; iproc++) {
+    ilat1 = clat * iproc / cproc;
+    ilat2 = clat * (iproc + 1) / cproc;
+#ifdef FORK
+    if (iproc < cproc-1) {
+      k = fork();
+      if (k > 0)
+        continue;
+      if (k < 0) {
+        fclose(rgfile[iproc]);
+        rgfile[iproc] = NULL;
+      }
+    }
+#endif
+    for (ilon = 0; ilon < clon; ilon++) {
+      is.RA = RFromD(Mod(us.fGeodetic ? -rglon[ilon] : rST - rglon[ilon]));
+      MC = CuspMidheaven();
+      for (ilat = ilat1; ilat < ilat2; ilat++) {
+        phi = &rghi[ilat*clon + ilon];
+        AA = Min(rglat[ilat], 89.9999);
+        AA = RFromD(Max(AA, -89.9999));
+        is.MC = MC;
+        is.Asc = CuspAscendant();
+        hRevers = 0;
+        if (RAbs(AA) > RFromD(rDegQuad - rAxis) &&
+          Mod(is.Asc - is.MC) > rDegHalf)
+          hRevers = 1;
+
+        /* Clamp the latitude where the system isn't defined the same as */
+        /* ComputeHouses() would, but without a warning for each point.  */
+
+        if (RAbs(AA) > RFromD(rDegQuad-rAxis) && us.nHouseSystem < 2)
+          AA = RSgn2(AA)*RFromD(rDegQuad-rAxis);
+        ComputeHouses(us.nHouseSystem);
+        phi->MC = is.MC; phi->Asc = is.Asc;
+        for (i = 1; i <= cSign; i++)
+          phi->cusp[i] = chouse[i];
+      }
+    }
+#ifdef FORK
+    if (iproc < cproc-1 && rgfile[iproc] != NULL) {
+      fwrite(&rghi[ilat1*clon], sizeof(HI), (ilat2-ilat1)*clon,
+        rgfile[iproc]);
+      fflush(rgfile[iproc]);
+      _exit(0);
+    }
+#endif
+  }
+
+  /* Wait for the child processes, then read back the rows each found. */
+
+#ifdef FORK
+  if (cproc > 1) {
+    while (wait(NULL) > 0)
+      ;
+    for (iproc = 0; iproc < cproc-1; iproc++) if (rgfile[iproc] != NULL) {
+      ilat1 = clat * iproc / cproc;
+      ilat2 = clat * (iproc + 1) / cproc;
+      rewind(rgfile[iproc]);
+      fread(&rghi[ilat1*clon], sizeof(HI), (ilat2-ilat1)*clon,
+        rgfile[iproc]);
+      fclose(rgfile[iproc]);
+    }
+  }
+#endif
+  ciCore = ciT; cp0 = cpT;
+  is.MC = MCT; is.Asc = AscT; is.RA = RAT; hRevers = hReversT;
+  return clon * clat;
+}
+
+
 /* Calculate the position of each planet with respect to the Gauquelin      */
 /* sectors. This is used by the sector charts. Fill out the planet position */
 /* array where one degree means 1/10 the way across one of the 36 sectors.  */
@@ -1133,9 +1604,152 @@ int obj1, asp, obj2;
 }
 
 
+/* Aspect sweeps: Rather than try each aspect between every pair of      */
+/* objects, sort one set of objects by longitude, and for each object of */
+/* the other set binary search the windows about each aspect angle. Only */
+/* the objects falling in a window need the exact test, so the work done */
+/* grows with the number of aspects present, not the number of pairs.    */
+
+SweepInfo rgsw[objMax];
+int csw = 0, rgswMark[objMax], nswMark = 0;
+real rswRad = 0.0, rswCap = 0.0;
+
+int CompareSweep(p1, p2)
+const void *p1, *p2;
+{
+  const SweepInfo *psw1 = (const SweepInfo *)p1,
+    *psw2 = (const SweepInfo *)p2;
+
+  if (psw1->lon != psw2->lon)
+    return psw1->lon < psw2->lon ? -1 : 1;
+  return psw1->obj - psw2->obj;
+}
+
+
+/* Sort a set of objects by longitude, to be searched by CSweepAspect()  */
+/* below. Each object carries an extra window width in 'rad', such as   */
+/* how far it moves over a search segment, and a limit on its orbs in   */
+/* 'cap'. Either array may be NULL, for no extra width or orb limit.    */
+
+void SetupSweep(lon, rad, cap, rgo, co)
+real *lon, *rad, *cap;
+int *rgo, co;
+{
+  int i;
+
+  rswRad = rswCap = 0.0;
+  for (i = 0; i < co; i++) {
+    rgsw[i].lon = Mod(lon[rgo[i]]);
+    rgsw[i].rad = rad != NULL ? rad[rgo[i]] : 0.0;
+    rgsw[i].cap = cap != NULL ? cap[rgo[i]] : rDegMax;
+    rgsw[i].obj = rgo[i];
+    rswRad = Max(rswRad, rgsw[i].rad);
+    rswCap = Max(rswCap, rgsw[i].cap);
+  }
+  qsort((void *)rgsw, (size_t)co, sizeof(SweepInfo), CompareSweep);
+  csw = co;
+}
+
+
+/* Given a longitude, window width, and orb limit for some object, fill in */
+/* 'rgo' with the objects of the set given to SetupSweep() that may be     */
+/* within any unrestricted aspect up to 'nAsp' of it, sorted by object     */
+/* index, and return how many. An object is included if its distance from  */
+/* the aspect is at most the aspect's orb in 'rgOrb' (or zero if NULL),    */
+/* limited by both objects' orb limits, plus both objects' window widths.  */
+
+int CSweepAspect(lon, rad, cap, rgOrb, nAsp, rgo)
+real lon, rad, cap, *rgOrb;
+int nAsp, *rgo;
+{
+  int co = 0, k, n, lo, hi, m, p;
+  real orb, r, w, l, x;
+
+  if (++nswMark <= 0) {
+    ClearB((lpbyte)rgswMark, sizeof(rgswMark));
+    nswMark = 1;
+  }
+  lon = Mod(lon);
+  for (k = 1; k <= nAsp; k++) if (!ignorea(k)) {
+    orb = rgOrb != NULL ? Min(rgOrb[k], cap) : 0.0;
+    w = (rgOrb != NULL ? Min(orb, rswCap) : 0.0) + rad + rswRad + rSweepSlack;
+    for (n = 0; n < 2; n++) {
+      if (n > 0 && (rAspAngle[k] <= 0.0 || rAspAngle[k] >= rDegHalf))
+        break;
+
+      /* Binary search for the start of the window, then walk forward */
+      /* around the zodiac until past its end.                        */
+
+      l = Mod(lon + (n ? -rAspAngle[k] : rAspAngle[k]) - w);
+      lo = 0; hi = csw;
+      while (lo < hi) {
+        p = (lo + hi) >> 1;
+        if (rgsw[p].lon < l)
+          lo = p+1;
+        else
+          hi = p;
+      }
+      for (m = 0, p = lo; m < csw; m++, p++) {
+        if (p >= csw)
+          p = 0;
+        if (w < rDegHalf && Mod(rgsw[p].lon - l) > 2.0*w)
+          break;
+        if (rgswMark[p] == nswMark)
+          continue;
+        r = (rgOrb != NULL ? Min(orb, rgsw[p].cap) : 0.0) + rad + rgsw[p].rad;
+        x = RAbs(MinDistance(lon, rgsw[p].lon) - rAspAngle[k]);
+        if (x > r + rSweepSlack)
+          continue;
+        rgswMark[p] = nswMark;
+        rgo[co++] = rgsw[p].obj;
+      }
+    }
+  }
+
+  /* The lists are short, so an insertion sort puts them in order fastest. */
+
+  for (m = 1; m < co; m++) {
+    n = rgo[m];
+    for (p = m; p > 0 && rgo[p-1] > n; p--)
+      rgo[p] = rgo[p-1];
+    rgo[p] = n;
+  }
+  is.cSweepAll += csw;
+  is.cSweepHit += co;
+  return co;
+}
+
+
+/* Fill in bounds on what GetOrb() can return under the current settings, */
+/* for use as aspect sweep windows: The orb of each aspect in 'rgOrb', the */
+/* orb limit of each object in 'rgCap', and each object's addition to its  */
+/* orbs in 'rgAdd'. The orb between two objects is never more than the     */
+/* aspect's orb limited by either object's cap, plus both their additions. */
+
+void GetOrbBound(rgOrb, rgCap, rgAdd)
+real *rgOrb, *rgCap, *rgAdd;
+{
+  int i;
+  real f = 1.0;
+
+  if (us.fParallel) {
+    if (CoeffPar < 1.0)
+      f /= CoeffPar;
+  } else if ((us.nRel <= rcDual || us.fTransitInf) && CoeffComp < 1.0)
+    f /= CoeffComp;
+  for (i = 1; i <= cAspect; i++)
+    rgOrb[i] = rAspOrb[i]*f;
+  for (i = 0; i <= cObj; i++) {
+    rgCap[i] = (i > oNorm ? StarOrb : rObjOrb[i])*f;
+    rgAdd[i] = i > oNorm ? 0.0 : Max(rObjAdd[i], 0.0)*f;
+  }
+}
+
+
 /* This is a subprocedure of FCreateGrid() and FCreateGridRelation().   */
 /* Given two planets, determine what aspect, if any, is present between */
 /* them, and save the aspect name and orb in the specified grid cell.   */
+/* The caller should have called EnsureOrbTab() to bring orbs current.  */
 
 void GetAspect(planet1, planet2, ret1, ret2, i, j)
 real *planet1, *planet2, *ret1, *ret2;
@@ -1150,7 +1764,7 @@ int i, j;
     if (!FAcceptAspect(i, k, j))
       continue;
     m = l-rAspAngle[k];
-    if (RAbs(m) < GetOrb(i, j, k)) {
+    if (RAbs(m) < OrbTab(i, j, k)) {
       grid->n[i][j] = k;
 
       /* If -ga switch in effect, then change the sign of the orb to    */
@@ -1190,7 +1804,7 @@ int i, j;
     if (!FAcceptAspect(i, k, j))
       continue;
     l = (k == aCon ? RAbs(alt1 - alt2) : RAbs(alt2) - RAbs(alt1));
-    if (RAbs(l) < GetOrb(i, j, k)) {
+    if (RAbs(l) < OrbTab(i, j, k)) {
       grid->n[i][j] = k;
 #ifdef PLACALC
       if (us.fAppSep && us.fPlacalc) {
@@ -1213,11 +1827,12 @@ int i, j;
 bool FCreateGrid(fFlip)
 bool fFlip;
 {
-  int i, j, k;
-  real l;
+  int rgo[objMax], rgo2[objMax], co = 0, c, i, j, k;
+  real rgOrb[cAspect+1], rgCap[objMax], rgAdd[objMax], l;
 
   if (!FEnsureGrid())
     return fFalse;
+  EnsureOrbTab();
   for (j = 0; j <= cObj; j++) if (!FIgnore(j))
     for (i = 0; i <= cObj; i++) if (!FIgnore(i))
 
@@ -1228,7 +1843,7 @@ bool fFlip;
         if (us.fParallel)
           GetParallel(planet, planet, planetalt, planetalt, ret, ret, altret, altret, i, j);
         else
-          GetAspect(planet, planet, ret, ret, i, j);
+          grid->v[i][j] = grid->n[i][j] = 0;
       } else if (fFlip ? i < j : i > j) {
         l = Mod(Midpoint(planet[i], planet[j])); k = (int)l;  /* Calculate */
         grid->n[i][j] = k/30+1;                               /* midpoint. */
@@ -1237,6 +1852,29 @@ bool fFlip;
         grid->n[i][j] = SFromZ(planet[j]);
         grid->v[i][j] = (int)(planet[j]-(real)(grid->n[i][j]-1)*30.0);
       }
+
+  /* Aspects only need to be looked for between pairs an orb sweep finds. */
+  /* Stars can't aspect each other, so only the other objects are swept, */
+  /* which also means pairs with a star are found by its narrow windows. */
+
+  if (!us.fParallel) {
+    GetOrbBound(rgOrb, rgCap, rgAdd);
+    for (i = 0; i <= cObj; i++) if (!FIgnore(i) && !FStar(i))
+      rgo[co++] = i;
+    SetupSweep(planet, rgAdd, rgCap, rgo, co);
+    for (i = 0; i <= cObj; i++) if (!FIgnore(i)) {
+      c = CSweepAspect(planet[i], rgAdd[i], rgCap[i], rgOrb, us.nAsp, rgo2);
+      for (k = 0; k < c; k++) {
+        j = rgo2[k];
+        if (!FStar(i) && j <= i)
+          continue;
+        if (fFlip ? i > j : i < j)
+          GetAspect(planet, planet, ret, ret, i, j);
+        else
+          GetAspect(planet, planet, ret, ret, j, i);
+      }
+    }
+  }
   return fTrue;
 }
 
@@ -1248,23 +1886,47 @@ bool fFlip;
 bool FCreateGridRelation(fMidpoint)
 bool fMidpoint;
 {
-  int i, j, k;
-  real l;
+  int rgo[objMax], rgo2[objMax], co, c, i, j, k, n;
+  real rgOrb[cAspect+1], rgCap[objMax], rgAdd[objMax], l;
 
   if (!FEnsureGrid())
     return fFalse;
+  EnsureOrbTab();
   for (j = 0; j <= cObj; j++) if (!FIgnore(j) || !FIgnore2(j) || !FIgnore3(j))
     for (i = 0; i <= cObj; i++) if (!FIgnore(i) || !FIgnore2(i) || !FIgnore3(i))
       if (!fMidpoint) {
         if (us.fParallel)
           GetParallel(cp1.obj, cp2.obj, cp1.alt, cp2.alt, cp1.dir, cp2.dir, cp1.altdir, cp2.altdir, i, j);
         else
-          GetAspect(cp1.obj, cp2.obj, cp1.dir, cp2.dir, i, j);
+          grid->v[i][j] = grid->n[i][j] = 0;
       } else {
         l = Mod(Midpoint(cp2.obj[i], cp1.obj[j])); k = (int)l; /* Calculate */
         grid->n[i][j] = k/30+1;                                /* midpoint. */
         grid->v[i][j] = (int)((l-(real)(k/30)*30.0)*60.0);
       }
+
+  /* As in FCreateGrid(), sweep the first chart's objects for aspect  */
+  /* windows about each object in the second chart: First the non-star */
+  /* objects about everything, then the stars about the non-stars.     */
+
+  if (!fMidpoint && !us.fParallel) {
+    GetOrbBound(rgOrb, rgCap, rgAdd);
+    for (n = 0; n < 2; n++) {
+      co = 0;
+      for (j = 0; j <= cObj; j++)
+        if ((!FIgnore(j) || !FIgnore2(j) || !FIgnore3(j)) && FStar(j) == n)
+          rgo[co++] = j;
+      SetupSweep(cp1.obj, rgAdd, rgCap, rgo, co);
+      for (i = 0; i <= cObj; i++) {
+        if ((FIgnore(i) && FIgnore2(i) && FIgnore3(i)) || (n && FStar(i)))
+          continue;
+        c = CSweepAspect(cp2.obj[i], rgAdd[i], rgCap[i], rgOrb, us.nAsp,
+          rgo2);
+        for (k = 0; k < c; k++)
+          GetAspect(cp1.obj, cp2.obj, cp1.dir, cp2.dir, i, rgo2[k]);
+      }
+    }
+  }
   return fTrue;
 }
 
@@ -231,6 +231,7 @@ void DisplaySwitches()
   PrintS("\nSwitches which determine the type of chart to display:");
   PrintS(" _v: Display list of object positions (chosen by default).");
   PrintS(" _v0: Like _v but express velocities relative to average speed.");
+  PrintS(" _vh: Like _v but display house cusps in every house system.");
   PrintS(" _w [<rows>]: Display chart in a graphic house wheel format.");
   PrintS(" _w0 [..]: Like _w but reverse order of objects in houses 4..9.");
   PrintS(" _g: Display aspect and midpoint grid among planets.");
@@ -255,6 +256,7 @@ void DisplaySwitches()
   PrintS(" _j0: Like _j but include influences of each zodiac sign as well.");
   PrintS(" _L [<step>]: Display astro-graph locations of planetary angles.");
   PrintS(" _L0 [..]: Like _L but display list of latitude crossings too.");
+  PrintS(" _Lh [..]: Like _L but display house cusps at each grid location.");
   PrintS(" _K: Display a calendar for given month.");
   PrintS(" _Ky: Like _K but display a calendar for the entire year.");
   PrintS(" _d [<step>]: Print all aspects and changes occurring in a day.");
@@ -341,6 +343,10 @@ void DisplaySwitches()
 #ifdef PLACALC
   PrintS(" _b: Use ephemeris files for more accurate location computations.");
   PrintS(" _b0: Like _b but display locations to the nearest second too.");
+#ifdef PLACALC
+  PrintS(" _bp <file>: Like _b but take locations from ephemeris pack file.");
+  PrintS(" _bj <file>: Like _b but compute locations with JPL ephemeris file.");
+#endif
 #endif
   PrintS(" _c <value>: Select a different default system of houses.");
   PrintS("     (0 = Placidus, 1 = Koch, 2 = Equal, 3 = Campanus,");
@@ -435,6 +441,18 @@ void DisplaySwitchesRare()
   PrintS(" _YP <-1,0,1>: Set how Arabic parts are computed for night charts.");
 #endif
   PrintS(" _Yb <days>: Set number of days to span for biorhythm chart.");
+  PrintS(" _YV: Print calculation and cache statistics after the charts.");
+#ifdef PLACALC
+  PrintS(" _Ye: Refine -d and -t event times by iterating on the ephemeris.");
+  PrintS(" _Yf <sec>: Fit ephemeris positions to cached curves within error.");
+  PrintS(" _Ys <0-16>: Set decoded ephemeris file segments kept per planet.");
+  PrintS(" _Yu <sec>: Interpolate nutation between days within error.");
+  PrintS(" _Ya <sec>: Use Matrix formulas within error for search brackets.");
+  PrintS(" _Yp <file> <year1> <year2>: Write ephemeris pack file for _bp.");
+#endif
+#ifdef FORK
+  PrintS(" _Yw <procs>: Split multiple month transit searches among processes.");
+#endif
   PrintS(" _YE <obj> <semi-major axis> <eccentricity (3)> <inclination (3)>");
   PrintS("     <perihelion (3)> <ascending node (3)> <time offset (3)>");
   PrintS("     Change orbit of object to be the given elements.");
@@ -762,6 +780,87 @@ void PrintOrbit()
 }
 
 
+/* Fill in an array with the cCalcStat counters -YV displays, in the     */
+/* order they're printed. Only this process' own work is counted, so the */
+/* transit searches can hand what their child processes did to parent.   */
+
+void GetCalcStats(rgl)
+long *rgl;
+{
+  int i;
+
+  rgl[0] = fc.cHit; rgl[1] = fc.cMiss;
+  rgl[2] = is.cCastFull; rgl[3] = is.cCastLight;
+  rgl[4] = cac.cReusePlanet; rgl[5] = cac.cReuseStar;
+  rgl[6] = is.cEventRefine; rgl[7] = is.cEventCalc;
+  rgl[8] = is.cTierMatrix;
+  rgl[9] = is.cSweepAll; rgl[10] = is.cSweepHit;
+  for (i = 11; i < cCalcStat; i++)
+    rgl[i] = 0L;
+#ifdef PLACALC
+  GetChebStats(&rgl[11], &rgl[12]);
+  GetSegStats(&rgl[13], &rgl[14]);
+  GetNutStats(&rgl[15], &rgl[16], &rgl[17]);
+  GetOscStats(&rgl[18], &rgl[19], &rgl[20]);
+#endif
+}
+
+
+/* Print statistics about the work done computing the charts just shown, */
+/* such as how often cached results could be used instead of being done  */
+/* over again. This is displayed after the charts when -YV is in effect. */
+/* Work done by child processes of -Yw searches is included in the sums. */
+
+void PrintCalcStats()
+{
+  byte sz[cchSzDef];
+  long rgl[cCalcStat];
+  int i;
+
+  GetCalcStats(rgl);
+  for (i = 0; i < cCalcStat; i++)
+    rgl[i] += is.rglStatFork[i];
+  if (is.fMult)
+    PrintL2();
+  AnsiColor(kWhite);
+  sprintf(sz, "%s calculation statistics:\n", szAppName); PrintSz(sz);
+  AnsiColor(kDefault);
+  sprintf(sz, "Data file lookups: %ld from cache, %ld searched.\n",
+    rgl[0], rgl[1]);
+  PrintSz(sz);
+  sprintf(sz, "Chart casts: %ld full, %ld skipping houses or stars.\n",
+    rgl[2], rgl[3]);
+  PrintSz(sz);
+  sprintf(sz, "Chart casts reusing last positions: %ld planets, %ld stars.\n",
+    rgl[4], rgl[5]);
+  PrintSz(sz);
+  sprintf(sz, "Event times refined: %ld, using %ld ephemeris calls.\n",
+    rgl[6], rgl[7]);
+  PrintSz(sz);
+  sprintf(sz, "Positions left to Matrix formulas within -Ya error: %ld.\n",
+    rgl[8]);
+  PrintSz(sz);
+  sprintf(sz, "Aspect sweeps: %ld object pairs looked over, %ld in windows.\n",
+    rgl[9], rgl[10]);
+  PrintSz(sz);
+#ifdef PLACALC
+  sprintf(sz, "Ephemeris positions: %ld from fitted curves, %ld curves fit.\n",
+    rgl[11], rgl[12]);
+  PrintSz(sz);
+  sprintf(sz, "Ephemeris file segments: %ld kept in memory, %ld decoded.\n",
+    rgl[13], rgl[14]);
+  PrintSz(sz);
+  sprintf(sz, "Nutation: %ld computed, %ld interpolated; "
+    "%ld precessions reused matrix.\n", rgl[15], rgl[16], rgl[17]);
+  PrintSz(sz);
+  sprintf(sz, "True node and apogee: %ld from cache, %ld computed; "
+    "%ld shared Moon.\n", rgl[18], rgl[19], rgl[20]);
+  PrintSz(sz);
+#endif
+  is.fMult = fTrue;
+}
+
+
 #ifdef ARABIC
 /* Compare the strings corresponding to two Arabic part formulas. Like   */
 /* NCompareSz, this returns 0 if they are equal, a positive value if the */
@@ -980,6 +980,7 @@ void ChartMidpoint()
 
   ClearB((lpbyte)cs, (cSign + 1)*(int)sizeof(int));
   is.fSeconds = fFalse;
+  EnsureOrbTab();
   loop {
     mlo = 21600;
 
@@ -1026,7 +1027,7 @@ void ChartMidpoint()
         if (!FAcceptAspect(i, k, ilo))
           continue;
         n = l-rAspAngle[k];
-        if (RAbs(n) < GetOrb(i, ilo, k)) {
+        if (RAbs(n) < OrbTab(i, ilo, k)) {
           if (us.fAppSep)
             n = RSgn2((ret[ilo]+ret[jlo])/2.0-ret[i])*
               RSgn2(MinDifference(planet[i], mid))*RSgn2(n)*RAbs(n);
@@ -1586,6 +1587,97 @@ void ChartAstroGraph()
 }
 
 
+/* Print the column headings of the -vh and -Lh charts, after the given  */
+/* label for the first column. The cusps of houses 7 through 12 aren't   */
+/* shown, since each is always opposite the corresponding one of 1 to 6. */
+
+void PrintHouseInfoHeader(szLabel)
+byte *szLabel;
+{
+  byte sz[cchSzDef];
+  int cch = is.fSeconds ? 11 : 7, i;
+
+  AnsiColor(kDefault);
+  PrintSz(szLabel);
+  sprintf(sz, " %-*s %-*s", cch, "Midheav", cch, "Ascend."); PrintSz(sz);
+  for (i = 1; i <= cSign/2; i++) {
+    sprintf(sz, " %d%s%*s", i, szSuffix[i], cch-3, ""); PrintSz(sz);
+  }
+  PrintL();
+}
+
+
+/* Print the Midheaven, Ascendant, and cusps of houses 1 through 6 stored */
+/* in a house info record, as the rest of a line of the -vh or -Lh chart. */
+
+void PrintHouseInfo(phi)
+HI *phi;
+{
+  int i;
+
+  PrintCh(' '); PrintZodiac(phi->MC);
+  PrintCh(' '); PrintZodiac(phi->Asc);
+  for (i = 1; i <= cSign/2; i++) {
+    PrintCh(' '); PrintZodiac(phi->cusp[i]);
+  }
+  PrintL();
+}
+
+
+/* Print the Midheaven, Ascendant, and house cusps of the current chart as */
+/* they would be in each of the house systems, as done with the -vh switch. */
+
+void ChartHouseSystems()
+{
+  HI rghi[cSystem];
+  byte sz[cchSzDef];
+  int sys;
+
+  ComputeHousesAll(rghi);
+  PrintHeader();
+  PrintL();
+  PrintHouseInfoHeader("House system ");
+  for (sys = 0; sys < cSystem; sys++) {
+    AnsiColor(sys == us.nHouseSystem ? kWhite : kDefault);
+    sprintf(sz, "%-13s", szSystem[sys]); PrintSz(sz);
+    PrintHouseInfo(&rghi[sys]);
+  }
+}
+
+
+/* Print the Midheaven, Ascendant, and house cusps of the current chart as */
+/* they would be if it were relocated to each point of a grid covering the */
+/* Earth, as done with the -Lh switch. The grid has the same spacing as   */
+/* the -L chart, and is ordered from north to south and then west to east. */
+
+void ChartHouseGrid()
+{
+  HI *rghi;
+  real rglon[360], rglat[161];
+  byte sz[cchSzDef];
+  int clon = 0, clat = 0, ilon, ilat, i;
+
+  for (i = 180; i > -180; i -= us.nAstroGraphStep)
+    rglon[clon++] = (real)i;
+  for (i = 80; i >= -80; i -= us.nAstroGraphStep)
+    rglat[clat++] = (real)i;
+  if ((rghi = (HI *)PAllocate((long)clon*clat*sizeof(HI), fTrue,
+    "house grid")) == NULL)
+    return;
+  CastHouseGrid(rglon, clon, rglat, clat, rghi);
+  PrintHouseInfoHeader("Lati Long");
+  for (ilat = 0; ilat < clat; ilat++)
+    for (ilon = 0; ilon < clon; ilon++) {
+      AnsiColor(kDefault);
+      sprintf(sz, "%3.0f%c %3.0f%c", RAbs(rglat[ilat]),
+        rglat[ilat] < 0.0 ? 's' : 'n', RAbs(rglon[ilon]),
+        rglon[ilon] < 0.0 ? 'e' : 'w'); PrintSz(sz);
+      PrintHouseInfo(&rghi[ilat*clon + ilon]);
+    }
+  DeallocateFar(rghi);
+}
+
+
 /* Another important procedure: Display any of the types of (text) charts    */
 /* that the user specified they wanted, by calling the appropriate routines. */
 
@@ -1597,9 +1689,12 @@ bool fProg;
   if (us.fListing) {
     if (is.fMult)
       PrintL2();
-    if (us.nRel < rcDifference)
-      ChartListing();
-    else
+    if (us.nRel < rcDifference) {
+      if (us.fHouseSystems)
+        ChartHouseSystems();
+      else
+        ChartListing();
+    } else
 
       /* If the -rb or -rd relationship charts are in effect, then instead  */
       /* of doing the standard -v chart, print either of these chart types. */
@@ -1708,7 +1803,10 @@ bool fProg;
   if (us.fAstroGraph) {
     if (is.fMult)
       PrintL2();
-    ChartAstroGraph();
+    if (us.fHouseGrid)
+      ChartHouseGrid();
+    else
+      ChartAstroGraph();
     is.fMult = fTrue;
   }
   if (us.fCalendar) {
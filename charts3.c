@@ -59,9 +59,15 @@ bool fProg;
   byte sz[cchSzDef];
   int source[MAXINDAY], aspect[MAXINDAY], dest[MAXINDAY],
     sign1[MAXINDAY], sign2[MAXINDAY], D1, D2, counttotal = 0, occurcount,
-    division, div, fYear, yea0, yea1, yea2, i, j, k, l, s1, s2;
-  real time[MAXINDAY], divsiz, d1, d2, e1, e2, f1, f2, g, time1, time2;
+    division, div, fYear, yea, yea0, yea1, yea2, i, j, k, l, s1, s2,
+    rgo[objMax], rgo2[objMax], co, c, n;
+  real time[MAXINDAY], divsiz, d1, d2, e1, e2, f1, f2, g, time1, time2,
+    rgMove[objMax];
   CI ciT;
+#ifdef PLACALC
+  real jd0, jd1, jd2, jd;
+  bool fRefine;
+#endif
 
   /* If parameter 'fProg' is set, look for changes in a progressed chart. */
 
@@ -70,6 +76,11 @@ bool fProg;
   division = (fYear || fProg) ? 1 : us.nDivision;
   divsiz = 24.0 / (real)division*60.0;
 
+  /* Only non-cusp objects are searched, so the charts cast along the way */
+  /* don't need houses, unless -f needs them to compute positions.        */
+
+  is.fNoHouse = !fProg && !us.fFlip;
+
   /* If -dY in effect, then search through a range of years. */
 
   yea1 = fProg ? YeaT : Yea;
@@ -99,6 +110,11 @@ bool fProg;
       is.JDp = MdytszToJulian(MonT, DD, yea0, 0.0, Dst, Zon);
       ciCore = ciMain;
     }
+#ifdef PLACALC
+    fRefine = FEventRefine();
+    is.fCoarse = fRefine && us.rEphTier > 0.0;
+    jd0 = MdytszToJulian(MM, DD, YY, 0.0, Dst, Zon) - 0.5;
+#endif
     CastChart(fTrue);
     cp2 = cp0;
 
@@ -118,6 +134,10 @@ bool fProg;
       }
       CastChart(fTrue);
       cp1 = cp2; cp2 = cp0;
+#ifdef PLACALC
+      jd1 = jd0 + (real)(div-1)*divsiz/(24.0*60.0);
+      jd2 = jd0 + (real)div*divsiz/(24.0*60.0);
+#endif
 
       if (us.fParallel) {
         for (i = 0; i <= cObj; i++) if (!ignore[i]) {
@@ -139,6 +159,19 @@ bool fProg;
         }
       }
 
+      /* An aspect can only become exact during the segment if the pair */
+      /* starts within the distance both objects move of the aspect, so */
+      /* sweep for those pairs rather than trying every pair in turn.  */
+
+      if (!us.fParallel) {
+        co = 0;
+        for (i = 0; i <= cObj; i++) if (!FIgnore(i) && (fProg || FThing(i))) {
+          rgo[co++] = i;
+          rgMove[i] = MinDistance(cp1.obj[i], cp2.obj[i]);
+        }
+        SetupSweep(cp1.obj, rgMove, NULL, rgo, co);
+      }
+
        /* Now search through the present segment for anything exciting. */
 
         for (i = 0; i <= cObj; i++) if (!FIgnore(i) && (fProg || FThing(i))) {
@@ -153,9 +186,20 @@ bool fProg;
             source[occurcount] = i;
             aspect[occurcount] = aSig;
             dest[occurcount] = s2+1;
-            time[occurcount] = MinDistance(cp1.obj[i],
-              (real)(cp1.dir[i] >= 0.0 ? s2 : s1) * 30.0) /
+
+            /* The sign boundary crossed depends on which way the planet */
+            /* moved over the segment, which isn't the direction at its  */
+            /* start if the planet stations during it.                   */
+
+            d1 = (real)(Mod(cp2.obj[i] - cp1.obj[i]) < rDegHalf ? s2 : s1) *
+              30.0;
+            time[occurcount] = MinDistance(cp1.obj[i], d1) /
               MinDistance(cp1.obj[i], cp2.obj[i])*divsiz + (real)(div-1)*divsiz;
+#ifdef PLACALC
+            if (fRefine && FRefineEvent(evLon, i, -1, d1 - is.rSid,
+              jd1, jd2, &jd))
+              time[occurcount] = (jd - jd0)*24.0*60.0;
+#endif
             sign1[occurcount] = sign2[occurcount] = s1+1;
             occurcount++;
           }
@@ -168,13 +212,18 @@ bool fProg;
             dest[occurcount] = cp2.dir[i] < 0.0;
             time[occurcount] = RAbs(cp1.dir[i])/(RAbs(cp1.dir[i])+
               RAbs(cp2.dir[i]))*divsiz + (real)(div-1)*divsiz;
+#ifdef PLACALC
+            if (fRefine && FRefineEvent(evSpeed, i, -1, 0.0, jd1, jd2, &jd))
+              time[occurcount] = (jd - jd0)*24.0*60.0;
+#endif
             sign1[occurcount] = sign2[occurcount] = s1+1;
             occurcount++;
           }
 
         /* Now search for anything making an aspect to the current planet. */
 
-          for (j = i+1; j <= cObj; j++) if (!FIgnore(j) && (fProg || FThing(j)))
+          c = CSweepAspect(cp1.obj[i], rgMove[i], 0.0, NULL, us.nAsp, rgo2);
+          for (n = 0; n < c; n++) if ((j = rgo2[n]) > i)
             for (k = 1; k <= us.nAsp; k++) if (FAcceptAspect(i, k, j)) {
               d1 = cp1.obj[i]; d2 = cp2.obj[i];
               e1 = cp1.obj[j]; e2 = cp2.obj[j];
@@ -225,6 +274,12 @@ bool fProg;
                 g = (RAbs(d1-e1) > rDegHalf ?
                   (d1-e1)-RSgn(d1-e1)*rDegMax : d1-e1)/(f2-f1);
                 time[occurcount] = g*divsiz + (real)(div-1)*divsiz;
+#ifdef PLACALC
+                if (fRefine && FRefineAspect(i, j, 0.0, k, jd1, jd2, &jd)) {
+                  time[occurcount] = (jd - jd0)*24.0*60.0;
+                  g = (time[occurcount] - (real)(div-1)*divsiz) / divsiz;
+                }
+#endif
                 sign1[occurcount] = (int)(Mod(cp1.obj[i]+
                   RSgn(cp2.obj[i]-cp1.obj[i])*
                   (RAbs(cp2.obj[i]-cp1.obj[i]) > rDegHalf ? -1 : 1)*
@@ -310,9 +365,8 @@ bool fProg;
     /* Finally, loop through and display each aspect and when it occurs. */
 
       for (i = 0; i < occurcount; i++) {
-        s1 = (int)time[i]/60;
-        s2 = (int)time[i]-s1*60;
         j = DayT;
+        l = Mon;
         if (fYear || fProg) {
           l = MonT;
           while (j > (k = DayInMonth(l, yea0))) {
@@ -320,14 +374,26 @@ bool fProg;
             l++;
           }
         }
-        SetCI(ciSave, fYear || fProg ? l : Mon, j, yea0,
+        yea = yea0;
+
+        /* A time refined from the ephemeris may fall just outside the day */
+        /* if the search chart was cast with -Ya, so move it to its date.  */
+
+        if (is.fCoarse && (time[i] < 0.0 || time[i] >= 24.0*60.0)) {
+          k = NFloor(time[i] / (24.0*60.0));
+          time[i] -= (real)k*24.0*60.0;
+          JulianToMdy((real)(MdyToJulian(l, j, yea) + k), &l, &j, &yea);
+        }
+        s1 = (int)time[i]/60;
+        s2 = (int)time[i]-s1*60;
+        SetCI(ciSave, l, j, yea,
           DegToDec(time[i] / 60.0), Dst, Zon, Lon, Lat);
-        k = DayOfWeek(fYear || fProg ? l : Mon, j, yea0);
+        k = DayOfWeek(l, j, yea);
         AnsiColor(kRainbowA[k + 1]);
         sprintf(sz, "(%c%c%c) ", chDay3(k)); PrintSz(sz);
         AnsiColor(kDefault);
         sprintf(sz, "%s %s ",
-          SzDate(fYear || fProg ? l : Mon, j, yea0, 2*MonthFormat),
+          SzDate(l, j, yea, 2*MonthFormat),
           SzTime(s1, s2, -1)); PrintSz(sz);
         PrintAspect(source[i], sign1[i],
           (int)RSgn(cp1.dir[source[i]])+(int)RSgn(cp2.dir[source[i]]),
@@ -344,6 +410,7 @@ bool fProg;
 
   /* Recompute original chart placements as we've overwritten them. */
 
+  is.fNoHouse = is.fCoarse = fFalse;
   ciCore = ciMain;
   ciTran = ciT;
   CastChart(fTrue);
@@ -363,10 +430,22 @@ bool fProg;
   byte sz[cchSzDef];
   int source[MAXINDAY], aspect[MAXINDAY], dest[MAXINDAY], sign[MAXINDAY],
     isret[MAXINDAY], M1, M2, Y1, Y2, counttotal = 0, occurcount, division,
-    div, nAsp, fCusp, i, j, k, s1, s2, s3;
-  real lonn[objMax], latn[objMax];
+    div, nAsp, fCusp, i, j, k, s1, s2, s3, cmon, im, im1, im2, cproc, iproc,
+    rgo[objMax], rgo2[objMax], co, c, n, mon, day, yea;
+  real lonn[objMax], latn[objMax], rgMove[objMax];
+  bool fSweep;
   real divsiz, daysiz, d, e1, e2, f1, f2;
   CI ciT;
+#ifdef FORK
+  FILE *rgfile[cSearchProc], *fileT;
+  byte szLine[cchSzMax];
+  long rglStat[cCalcStat], rglStat0[cCalcStat];
+  int fChild = fFalse;
+#endif
+#ifdef PLACALC
+  real jd0, jd1, jd2, jd;
+  bool fRefine;
+#endif
 
   /* Save away natal chart and initialize things. */
 
@@ -396,6 +475,13 @@ bool fProg;
     division = Max(division, 96);
   nAsp = is.fReturn ? aCon : us.nAsp;
 
+  /* Stars can't make transits, and if no cusps are transiting either, the */
+  /* charts cast for each segment don't need any houses or stars computed. */
+  /* (The =YU star restrictions do depend on the current star positions.) */
+
+  is.fNoStar = !StarRest && !PrimeRest;
+  is.fNoHouse = fCusp && !us.fFlip;
+
       if (us.fParallel) {
         for (i = 0; i <= cObj; i++) if (!ignore[i]) {
           if (us.fEquator) {
@@ -427,23 +513,69 @@ bool fProg;
     }
   }
 
-  /* Start searching the year or years in question for any transits. */
-
-  for (YeaT = Y1; YeaT <= Y2; YeaT++)
+  /* If more than one process is to be used, divide the months to search */
+  /* into equal slices. Each slice is searched by its own child process  */
+  /* writing into a temporary file, except the last which is searched    */
+  /* here, and the files are printed in order once all are finished.     */
+  /* Each file starts with room for the -YV counters of the slice, which */
+  /* the child fills in when done, so the parent can add them to its own. */
+
+  cmon = M2 - M1 + 1;
+  cproc = 1;
+#ifdef FORK
+  cproc = Min(Min(us.nSearchProc, cSearchProc), (Y2 - Y1 + 1) * cmon);
+  fileT = is.S;
+  for (iproc = 0; iproc < cproc && cproc > 1; iproc++)
+    if ((rgfile[iproc] = tmpfile()) == NULL) {
+      while (--iproc >= 0)
+        fclose(rgfile[iproc]);
+      cproc = 1;
+    }
+  if (cproc > 1) {
+    GetCalcStats(rglStat0);
+    ClearB((lpbyte)rglStat, sizeof(rglStat));
+    for (iproc = 0; iproc < cproc; iproc++)
+      fwrite(rglStat, sizeof(long), cCalcStat, rgfile[iproc]);
+  }
+  fflush(NULL);
+#endif
+  for (iproc = 0; iproc < cproc; iproc++) {
+    im1 = (Y2 - Y1 + 1) * cmon * iproc / cproc;
+    im2 = (Y2 - Y1 + 1) * cmon * (iproc + 1) / cproc;
+#ifdef FORK
+    if (cproc > 1) {
+      if (iproc < cproc-1) {
+        k = fork();
+        if (k > 0)
+          continue;
+        fChild = k == 0;
+      }
+      is.S = rgfile[iproc];
+    }
+#endif
 
   /* Start searching the month or months in question for any transits. */
 
-  for (MonT = M1; MonT <= M2; MonT++) {
+  for (im = im1; im < im2; im++) {
+    YeaT = Y1 + im / cmon;
+    MonT = M1 + im % cmon;
     daysiz = (real)DayInMonth(MonT, YeaT)*24.0*60.0;
     divsiz = daysiz / (real)division;
 
     /* Cast chart for beginning of month and store it for future use. */
 
     SetCI(ciCore, MonT, 1, YeaT, 0.0, DstT, ZonT, LonT, LatT);
+#ifdef PLACALC
+    jd0 = MdytszToJulian(MM, DD, YY, 0.0, DstT, ZonT) - 0.5;
+#endif
     if (us.fProgress = fProg) {
       is.JDp = MdytszToJulian(MM, DD, YY, 0.0, DstT, ZonT);
       ciCore = ciMain;
     }
+#ifdef PLACALC
+    fRefine = FEventRefine();
+    is.fCoarse = fRefine && us.rEphTier > 0.0;
+#endif
     for (i = 0; i <= oNorm; i++)
       SwapN(ignore[i], ignore2[i]);
     CastChart(fTrue);
@@ -472,6 +604,10 @@ bool fProg;
       for (i = 0; i <= oNorm; i++)
         SwapN(ignore[i], ignore2[i]);
       cp1 = cp2; cp2 = cp0;
+#ifdef PLACALC
+      jd1 = jd0 + (real)(div-1)*divsiz/(24.0*60.0);
+      jd2 = jd0 + (real)div*divsiz/(24.0*60.0);
+#endif
 
       if (us.fParallel) {
         for (i = 0; i <= cObj; i++) if (!ignore[i]) {
@@ -493,11 +629,30 @@ bool fProg;
         }
       }
 
+      /* A transit can only happen during the segment to a natal position */
+      /* the transiting object starts within its motion of aspecting, so  */
+      /* sweep for those rather than trying every transiting object.      */
+
+      fSweep = !us.fParallel && !is.fReturn;
+      if (fSweep) {
+        co = 0;
+        for (j = 0; j <= oNorm; j++) {
+          if (FIgnore2(j) || (fCusp && !FThing(j)))
+            continue;
+          rgo[co++] = j;
+          rgMove[j] = MinDistance(cp1.obj[j], cp2.obj[j]);
+        }
+        SetupSweep(cp1.obj, rgMove, NULL, rgo, co);
+      }
+
       /* Now search through the present segment for any transits. Note that */
       /* stars can be transited, but they can't make transits themselves.   */
 
       for (i = 0; i <= cObj; i++) if (!FIgnore(i)) {
-        for (j = 0; j <= oNorm; j++) {
+        c = fSweep ? CSweepAspect(planet3[i], 0.0, 0.0, NULL, nAsp, rgo2) :
+          oNorm+1;
+        for (n = 0; n < c; n++) {
+          j = fSweep ? rgo2[n] : n;
           if ((is.fReturn ? i != j : FIgnore2(j)) || (fCusp && !FThing(j)))
             continue;
 
@@ -536,6 +691,11 @@ bool fProg;
                 dest[occurcount] = i;
                 time[occurcount] = RAbs(f1)/(RAbs(f1)+RAbs(f2))*divsiz +
                   (real)(div-1)*divsiz;
+#ifdef PLACALC
+                if (fRefine && FRefineAspect(j, -1, d - is.rSid, k,
+                  jd1, jd2, &jd))
+                  time[occurcount] = (jd - jd0)*24.0*60.0;
+#endif
                 sign[occurcount] = (int)(Mod(
                   MinDistance(cp1.obj[j], Mod(d-rAspAngle[k])) <
                   MinDistance(cp2.obj[j], Mod(d+rAspAngle[k])) ?
@@ -594,14 +754,28 @@ bool fProg;
       /* Now loop through list and display all the transits. */
 
       for (i = 0; i < occurcount; i++) {
+        mon = MonT; yea = YeaT;
         s1 = (_int)time[i]/24/60;
+
+        /* A time refined from the ephemeris may fall just outside the    */
+        /* month if the search chart was cast with -Ya, so move its date. */
+
+        if (is.fCoarse && (time[i] < 0.0 ||
+          time[i] >= (real)DayInMonth(MonT, YeaT)*24.0*60.0)) {
+          s1 = NFloor(time[i] / (24.0*60.0));
+          time[i] -= (real)s1*24.0*60.0;
+          JulianToMdy((real)(MdyToJulian(MonT, 1, YeaT) + s1),
+            &mon, &day, &yea);
+          s1 = 0;
+        } else
+          day = s1+1;
         s3 = (_int)time[i]-s1*24*60;
         s2 = s3/60;
         s3 = s3-s2*60;
-        SetCI(ciSave, MonT, s1+1, YeaT, DegToDec((real)
+        SetCI(ciSave, mon, day, yea, DegToDec((real)
           ((_int)time[i]-s1*24*60) / 60.0), DstT, ZonT, LonT, LatT);
         sprintf(sz, "%s %s ",
-          SzDate(MonT, s1+1, YeaT, 2*MonthFormat), SzTime(s2, s3, -1)); PrintSz(sz);
+          SzDate(mon, day, yea, 2*MonthFormat), SzTime(s2, s3, -1)); PrintSz(sz);
         PrintAspect(source[i], sign[i], isret[i], aspect[i],
           dest[i], SFromZ(planet3[dest[i]]), (int)RSgn(ret3[dest[i]]),
           (byte)(fProg ? 'u' : 't'));
@@ -624,6 +798,45 @@ bool fProg;
       counttotal += occurcount;
     }
   }
+#ifdef FORK
+    if (fChild) {
+      GetCalcStats(rglStat);
+      for (i = 0; i < cCalcStat; i++)
+        rglStat[i] -= rglStat0[i];
+      fflush(is.S);
+      fseek(is.S, 0L, SEEK_SET);
+      fwrite(rglStat, sizeof(long), cCalcStat, is.S);
+      fflush(is.S);
+      _exit(0);
+    }
+    is.S = fileT;
+  }
+
+  /* Wait for the child processes, then print what each slice found. The */
+  /* lines were already clipped when first printed, so don't clip again.  */
+
+  if (cproc > 1) {
+    while (wait(NULL) > 0)
+      ;
+    k = us.fClip80;
+    us.fClip80 = fFalse;
+    for (iproc = 0; iproc < cproc; iproc++) {
+      rewind(rgfile[iproc]);
+      if (fread(rglStat, sizeof(long), cCalcStat, rgfile[iproc]) ==
+        cCalcStat)
+        for (i = 0; i < cCalcStat; i++)
+          is.rglStatFork[i] += rglStat[i];
+      while (fgets(szLine, cchSzMax, rgfile[iproc]) != NULL) {
+        PrintSz(szLine);
+        counttotal++;
+      }
+      fclose(rgfile[iproc]);
+    }
+    us.fClip80 = k;
+  }
+#else
+  }
+#endif
   if (counttotal == 0)
     PrintSz("No transits found.\n");
 
@@ -635,6 +848,7 @@ bool fProg;
     fCP3 = 0;
   }
 #endif
+  is.fNoHouse = is.fNoStar = is.fCoarse = fFalse;
   ciCore = ciMain; ciTran = ciT;
   us.fProgress = fFalse;
   CastChart(fTrue);
@@ -834,6 +1048,10 @@ void ChartEphemeris()
     yea1 = yea2 = Yea; mon1 = mon2 = Mon;
   }
 
+  /* Only non-cusp objects are listed, so the charts don't need houses. */
+
+  is.fNoHouse = !us.fFlip;
+
   /* Loop through the year or years in question. */
 
   for (yea = yea1; yea <= yea2; yea++)
@@ -884,6 +1102,7 @@ void ChartEphemeris()
       PrintL();
   }
 
+  is.fNoHouse = fFalse;
   ciCore = ciMain;    /* Recast original chart. */
   CastChart(fTrue);
 }
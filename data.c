@@ -55,7 +55,7 @@ US NPTR us = {
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 
   /* Chart suboptions */
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 
   /* Table chart types */
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -77,7 +77,7 @@ US NPTR us = {
 #else
   fFalse,
 #endif
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 
   /* Value settings */
   0,
@@ -100,12 +100,13 @@ US NPTR us = {
 
   /* Value subsettings */
 
-  4, 5, cPart, 0.0, 365.2421988, 1, 1, 24, 0L, 0, BIODAYS};
+  4, 5, cPart, 0.0, 365.2421988, 1, 1, 24, 0L, 0, BIODAYS, 1, 0.0, 4, 0.0, 0.0, NULL,
+  NULL};
 
 IS NPTR is = {
-  fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse,
-  NULL, NULL, NULL, NULL, 0, 0, 0, 0.0, 0.0, 0.0,
-  NULL, 0.0, 0.0, 0.0, 0.0, 0.0};
+  fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse, fFalse,
+  fFalse, fFalse, NULL, NULL, NULL, NULL, 0, 0, 0, 0.0, 0.0, 0.0,
+  NULL, 0.0, 0.0, 0.0, 0.0, 0.0, 0L, 0L, 0L, 0L, 0L, 0L, 0L, 0L, {0L}};
 
 CI ciCore = {11, 19, 1971, 11.01, 0.0, 8.0, 122.20, 47.36, "", ""};
 CI ciMain = {-1, 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, "", ""};
@@ -436,6 +437,17 @@ real rTransitInf[oNorm+3] = {10,
   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
   50, 50, 50, 50, 50, 50, 50, 50, 50};
 
+  /* The largest difference in arc seconds between the positions of each  */
+  /* object computed by the Matrix formulas and by -b, found with charts  */
+  /* every three days from 1800 to 2200. Zero if the formulas can't be    */
+  /* used instead of -b for the object. The Node is the mean node.        */
+CONST real rMatrixErr[uranHi] = {0.0,
+  58.0, 486.0, 82.0, 121.0, 253.0, 4820.0, 1711.0, 1137.0, 9070.0, 14852.0,
+  0.0, 0.0, 0.0, 0.0, 0.0, 32.0,
+  0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+  0.0, 0.0,
+  3482.0, 2155.0, 818.0, 1891.0, 242.0, 414.0, 949.0, 1747.0};
+
 CONST real rObjDist[oVes+1] = {149.59787, 0.0, 0.3844,
   57.91, 108.2, 227.94, 778.33, 1426.98, 2870.99, 4497.07, 5913.52,
   13.670*149.59787, 2.767*149.59787, 2.770*149.59787, 2.669*149.59787,
@@ -672,5 +684,6 @@ byte fDisp = fTrue;
 
 byte *szFileNameSearch = "                ";
 byte szFilePathWin[cchSzMax] = "";
+FC fc;
 
 /* data.c */
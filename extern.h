@@ -99,6 +99,10 @@ extern bool FProcessSwitches P((int, byte **));
 #define inhouse   cp0.house
 
 #define ignorea(a) (rAspOrb[a] <= 0.0)
+#define OrbTab(obj1, obj2, asp) \
+  (rOrbTab[Min(obj1, starLo)][Min(obj2, starLo)][asp])
+#define InvalidateOrbs() is.lOrbVer++
+#define InvalidateCast() cac.fPlanet = cac.fStar = fFalse
 
 extern US NPTR us;
 extern IS NPTR is;
@@ -141,6 +145,7 @@ extern byte *szMindPart[oNorm+1], *szDesc[cSign+1], *szDesire[cSign+1],
   *szLifeArea[cSign+1], *szInteract[cAspectInt+1], *szTherefore[cAspectInt+1],
   *szModify[3][cAspectInt];
 
+extern CONST real rMatrixErr[uranHi];
 extern CONST real rObjDist[oVes+1], rObjYear[oVes+1], rObjDiam[oVes+1],
   rObjDay[oPlu+1], rObjMass[oPlu+1], rObjAxis[oPlu+1];
 extern CONST byte cSatellite[oPlu+1];
@@ -190,6 +195,9 @@ extern int DayInMonth P((int, int));
 extern int DaysInMonth P((int, int));
 extern int DayOfWeek P((int, int, int));
 extern int AddDay P((int, int, int, int));
+extern real RComputeOrb P((int, int, int));
+extern real rOrbTab[starLo+1][starLo+1][cAspect+1];
+extern void EnsureOrbTab P((void));
 extern real GetOrb P((int, int, int));
 extern void Terminate P((int));
 extern void PrintSz P((CONST byte *));
@@ -223,6 +231,8 @@ extern lpbyte PAllocate P((long, bool, byte *));
 
 /* From io.c */
 
+extern int IFileCache P((byte *, int));
+extern void FileCacheAdd P((byte *, int, byte *));
 extern FILE *FileOpen P((byte *, int));
 extern bool FProcessSwitchFile P((byte *, FILE *));
 extern bool FOutputData P((void));
@@ -235,6 +245,7 @@ extern bool FInputData P((byte *));
 extern bool FileFind P((byte *));
 extern byte *szFileNameSearch;
 extern byte szFilePathWin[cchSzMax];
+extern FC fc;
 
 /* From calc.c */
 
@@ -248,15 +259,29 @@ extern void HousePorphyryNeo P((void));
 extern void HouseWhole P((void));
 extern void HouseNull P((void));
 extern void ComputeHouses P((int));
+extern void ComputeHouseCusps P((int));
+extern void ComputeHousesAll P((HI *));
 extern void ComputeStars P((real));
 extern real Decan P((real));
 extern real Navamsa P((real));
 extern void SphToRec P((real, real, real, real *, real *, real *));
 extern void ComputePlacalc P((real));
+extern bool FEventRefine P((void));
+extern real REventValue P((int, int, int, real, real, bool *));
+extern bool FRefineEvent P((int, int, int, real, real, real, real *));
+extern bool FRefineAspect P((int, int, real, int, real, real, real *));
+extern CAC cac;
+extern void CastPlanets P((void));
+extern void CastStars P((real));
 extern real CastChart P((bool));
+extern int CastHouseGrid P((real *, int, real *, int, HI *));
 extern void CastSectors P((void));
 extern bool FEnsureGrid P((void));
 extern bool FAcceptAspect P((int, int, int));
+extern int CompareSweep P((const void *, const void *));
+extern void SetupSweep P((real *, real *, real *, int *, int));
+extern int CSweepAspect P((real, real, real, real *, int, int *));
+extern void GetOrbBound P((real *, real *, real *));
 extern void GetAspect P((real *, real *, real *, real *, int, int));
 extern void GetParallel P((real *, real *, real *, real *,real *, real *, real *, real *, int, int));
 extern bool FCreateGrid P((bool));
@@ -304,6 +329,9 @@ extern void ComputeVariables P((real *));
 extern real CuspMidheaven P((void));
 extern real CuspAscendant P((void));
 extern real CuspEastPoint P((void));
+extern HT ht;
+extern void ComputeHouseTrig P((void));
+extern void ComputeHouseTrigRA P((void));
 extern real CuspPlacidus P((real, real, bool));
 extern void HousePlacidus P((void));
 extern void HouseKoch P((void));
@@ -326,6 +354,22 @@ extern void ComputeLunar P((real *, real *, real *, real *));
 #ifdef PLACALC
 /* From swe_call.c */
 
+extern void PlacalcInit P((void));
+extern int IobjPlacalc P((int, int));
+extern void GetChebStats P((long *, long *));
+extern void GetSegStats P((long *, long *));
+extern void GetNutStats P((long *, long *, long *));
+extern void GetOscStats P((long *, long *, long *));
+extern real RPackStep P((int));
+extern void HermitePack P((float *, real, real, double *));
+extern void ClosePack P((void));
+extern bool FLoadPack P((void));
+extern float *PfPackNode P((int, double, double *, real *));
+extern bool FPackBody P((int, double, double *));
+extern bool FPackPlanet P((int, double, double *));
+extern bool FUsePack P((int));
+extern bool FPackCompute P((int, double, float *));
+extern bool FWritePack P((byte *, int, int));
 extern bool FPlacalcPlanet
   P((int, double, int, real *, real *, real *, real *, real *));
 extern double julday P((int, int, int, double, int));
@@ -350,6 +394,8 @@ extern void GetSzConstel P((byte *, int));
 extern void PrintConstellations P((void));
 #endif
 extern void PrintOrbit P((void));
+extern void GetCalcStats P((long *));
+extern void PrintCalcStats P((void));
 extern int NCompareSzPart P((int, int));
 extern void DisplayArabic P((void));
 #ifdef GRAPH
@@ -384,6 +430,10 @@ extern void ChartHorizon P((void));
 extern void ChartOrbit P((void));
 extern void ChartSector P((void));
 extern void ChartAstroGraph P((void));
+extern void PrintHouseInfoHeader P((byte *));
+extern void PrintHouseInfo P((HI *));
+extern void ChartHouseSystems P((void));
+extern void ChartHouseGrid P((void));
 extern void PrintChart P((bool));
 
 
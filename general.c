@@ -366,7 +366,7 @@ int month, day, year, delta;
 /* depends on the aspect itself, but some objects require narrow orbs,   */
 /* and some allow wider orbs, so check for these cases.                  */
 
-real GetOrb(obj1, obj2, asp)
+real RComputeOrb(obj1, obj2, asp)
 int obj1, obj2, asp;
 {
   real orb, r;
@@ -388,6 +388,43 @@ int obj1, obj2, asp;
 }
 
 
+/* The orb table holds RComputeOrb() for every pair of objects and aspect. */
+/* All stars share the same orbs, so they share one row, see OrbTab(). It  */
+/* is rebuilt when InvalidateOrbs() has been called since the last build,  */
+/* e.g. by switches such as -YAo, or when the chart type changes which of  */
+/* the -YOc or -YOp coefficients applies.                                  */
+
+real rOrbTab[starLo+1][starLo+1][cAspect+1];
+long lOrbTabVer = -1L;
+int nOrbTabMode = -1;
+
+void EnsureOrbTab()
+{
+  int mode, i, j, k;
+
+  mode = us.fParallel ? 2 : (us.nRel <= rcDual || us.fTransitInf);
+  if (lOrbTabVer == is.lOrbVer && nOrbTabMode == mode)
+    return;
+  for (i = 0; i <= starLo; i++)
+    for (j = 0; j <= starLo; j++)
+      for (k = 0; k <= cAspect; k++)
+        rOrbTab[i][j][k] = RComputeOrb(i, j, k);
+  lOrbTabVer = is.lOrbVer;
+  nOrbTabMode = mode;
+}
+
+
+/* Return the maximum orb allowed for an aspect between two objects, from */
+/* the orb table. Inner loops call EnsureOrbTab() once and use OrbTab().  */
+
+real GetOrb(obj1, obj2, asp)
+int obj1, obj2, asp;
+{
+  EnsureOrbTab();
+  return OrbTab(obj1, obj2, asp);
+}
+
+
 /*
 ******************************************************************************
 ** String Procedures.
@@ -46,6 +46,67 @@
 ******************************************************************************
 */
 
+/* Data files such as the fixstars.ast star file are looked for every time */
+/* a chart is cast, so remember where each file was found, to save going   */
+/* through the various directories again. The cache is only valid as long  */
+/* as the environment variables making up the search path stay the same,   */
+/* which is checked by comparing their values with those seen last time.   */
+/* Given a file name and search mode, return its index in the cache, or -1 */
+/* if the file hasn't been found yet.                                      */
+
+int IFileCache(szFile, nMode)
+byte *szFile;
+int nMode;
+{
+  int i;
+#ifdef ENVIRON
+  byte name[cchSzDef], *rgenv[3];
+
+  sprintf(name, "%s%s", ENVIRONVER, szVersionCore);
+  rgenv[0] = getenv(name);
+  rgenv[1] = getenv(ENVIRONALL);
+  rgenv[2] = getenv(ENVIRONVER);
+
+  /* If the search path changed, then forget everything found so far. */
+  for (i = 0; i < 3; i++) {
+    if (rgenv[i] == NULL)
+      rgenv[i] = "";
+    if (NCompareSz(rgenv[i], fc.szEnv[i]) != 0) {
+      sprintf(fc.szEnv[i], "%.254s", rgenv[i]);
+      fc.cfile = 0;
+    }
+  }
+#endif
+
+  for (i = 0; i < fc.cfile; i++)
+    if (fc.nMode[i] == nMode && NCompareSz(fc.szFile[i], szFile) == 0)
+      return i;
+  return -1;
+}
+
+
+/* Remember the place a file was found in the cache. Files not found */
+/* aren't remembered, as they may be created later. Neither are files */
+/* in the current directory, whose relative path would point elsewhere */
+/* if the directory changed, and which take only one fopen() to find.  */
+/* When the cache is full, start over.                                 */
+
+void FileCacheAdd(szFile, nMode, szPath)
+byte *szFile;
+int nMode;
+byte *szPath;
+{
+  if (CchSz(szFile) >= cchSzDef || CchSz(szPath) >= cchSzMax)
+    return;
+  if (fc.cfile >= cFileCache)
+    fc.cfile = 0;
+  strcpy(fc.szFile[fc.cfile], szFile);
+  strcpy(fc.szPath[fc.cfile], szPath);
+  fc.nMode[fc.cfile] = nMode;
+  fc.cfile++;
+}
+
+
 /* Open the file indicated by the given string and return the file's stream */
 /* pointer, or NULL if the file couldn't be found or opened. All parts of   */
 /* the program which open files to read call this routine. We look in       */
@@ -57,6 +118,7 @@ int nFileMode;
 {
   FILE *file;
   byte name[cchSzDef], mode[3];
+  int i;
 #ifdef ENVIRON
   byte *env;
 #endif
@@ -64,6 +126,18 @@ int nFileMode;
   /* Some file types we want to open as binary instead of Ascii. */
   sprintf(mode, "r%s", nFileMode == 2 ? "b" : "");
 
+  /* If we've found this file before, try the same place again. Files not */
+  /* found aren't remembered, as they may be created during the session.  */
+  i = IFileCache(szFile, nFileMode);
+  if (i >= 0) {
+    file = fopen(fc.szPath[i], mode);
+    if (file != NULL) {
+      fc.cHit++;
+      return file;
+    }
+  }
+  fc.cMiss++;
+
   /* First look for the file in the current directory. */
   file = fopen(szFile, mode);
   if (file != NULL)
@@ -77,8 +151,10 @@ int nFileMode;
   if (env && *env) {
     sprintf(name, "%s%c%s", env, chDirSep, szFile);
     file = fopen(name, mode);
-    if (file != NULL)
+    if (file != NULL) {
+      FileCacheAdd(szFile, nFileMode, name);
       return file;
+    }
   }
 
   /* Next look in the directory in the general environment variable. */
@@ -86,8 +162,10 @@ int nFileMode;
   if (env && *env) {
     sprintf(name, "%s%c%s", env, chDirSep, szFile);
     file = fopen(name, mode);
-    if (file != NULL)
+    if (file != NULL) {
+      FileCacheAdd(szFile, nFileMode, name);
       return file;
+    }
   }
 
   /* Next look in the directory in the version prefix environment variable. */
@@ -95,8 +173,10 @@ int nFileMode;
   if (env && *env) {
     sprintf(name, "%s%c%s", env, chDirSep, szFile);
     file = fopen(name, mode);
-    if (file != NULL)
+    if (file != NULL) {
+      FileCacheAdd(szFile, nFileMode, name);
       return file;
+    }
   }
 #endif
 
@@ -104,7 +184,9 @@ int nFileMode;
   sprintf(name, "%s%c%s", nFileMode == 0 ? DEFAULT_DIR :
     (nFileMode == 1 ? CHART_DIR : EPHE_DIR), chDirSep, szFile);
   file = fopen(name, mode);
-  if (file == NULL && nFileMode == 1) {
+  if (file != NULL)
+    FileCacheAdd(szFile, nFileMode, name);
+  else if (nFileMode == 1) {
     /* If the file was never found, print an error (unless we were looking */
     /* for a certain file type, e.g. the optional astrolog.dat file).      */
     sprintf(name, "File '%s' not found.", szFile);
@@ -772,10 +854,22 @@ byte *szWcommand;
 {
   byte name[cchSzMax], mode[3] = "r";
   FILE *file;
+  int i;
 #ifdef ENVIRON
   byte *env;
 #endif
 
+  /* If this file has been found before, we already know where it is. */
+
+  i = IFileCache(szFileNameSearch, -1);
+  if (i >= 0) {
+    fc.cHit++;
+    strcpy(szFilePathWin, szWcommand);
+    strcat(szFilePathWin, fc.szPath[i]);
+    return fTrue;
+  }
+  fc.cMiss++;
+
   /* First look for the file in the current directory. */
 
   file = fopen(szFileNameSearch, mode);
@@ -834,6 +928,7 @@ byte *szWcommand;
   }
   return fFalse;
 PrepLine:
+  FileCacheAdd(szFileNameSearch, -1, name);
   strcpy(szFilePathWin, szWcommand);
   strcat(szFilePathWin, name);
   return fTrue;
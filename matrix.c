@@ -304,6 +304,43 @@ real CuspEastPoint()
 }
 
 
+/* The trigonometry of the obliquity, latitude, and right ascension that */
+/* the house systems have in common. It's only recomputed when one of   */
+/* them changes, so computing several systems for a chart shares it.    */
+
+HT ht;
+
+void ComputeHouseTrig()
+{
+  if (ht.fSet && ht.OB == is.OB && ht.lat == AA && ht.RA == is.RA)
+    return;
+  ht.CosOB = RCos(is.OB); ht.SinOB = RSin(is.OB); ht.TanOB = RTan(is.OB);
+  ht.CosAA = RCos(AA); ht.TanAA = RTan(AA);
+  ht.TanAA0 = RTan(AA == 0.0 ? 0.0001 : AA);
+  ht.OB = is.OB; ht.lat = AA; ht.RA = is.RA;
+  ht.fSet = fTrue; ht.fRA = fFalse;
+}
+
+
+/* Fill in the terms of the right ascension plus each house's offset of */
+/* 60 degrees and more, used by the systems dividing the equator evenly. */
+
+void ComputeHouseTrigRA()
+{
+  real D;
+  int i;
+
+  if (ht.fRA)
+    return;
+  for (i = 1; i <= cSign; i++) {
+    D = RFromD(60.0+30.0*(real)i);
+    ht.rgCosRA[i] = RCos(is.RA+D);
+    ht.rgSinRA[i] = RSin(is.RA+D);
+  }
+  ht.fRA = fTrue;
+}
+
+
 /* These are various different algorithms for calculating the house cusps: */
 
 real CuspPlacidus(deg, FF, fNeg)
@@ -320,13 +357,13 @@ bool fNeg;
 
     /* This formula works except at 0 latitude (AA == 0.0). */
 
-    XS = X*RSin(R1)*RTan(is.OB)*RTan(AA == 0.0 ? 0.0001 : AA);
+    XS = X*RSin(R1)*ht.TanOB*ht.TanAA0;
     XS = RAcos(XS);
     if (XS < 0.0)
       XS += rPi;
     R1 = is.RA + (fNeg ? rPi-(XS/FF) : (XS/FF));
   }
-  LO = RAtn(RTan(R1)/RCos(is.OB));
+  LO = RAtn(RTan(R1)/ht.CosOB);
   if (LO < 0.0)
     LO += rPi;
   if (RSin(R1) < 0.0)
@@ -338,6 +375,7 @@ void HousePlacidus()
 {
   int i;
 
+  ComputeHouseTrig();
   chouse[1] = Mod(is.Asc-is.rSid);
   chouse[4] = Mod(is.MC+rDegHalf-is.rSid);
   chouse[5] = CuspPlacidus(30.0, 3.0, fFalse) + rDegHalf;
@@ -357,7 +395,8 @@ void HouseKoch()
   real A1, A2, A3, KN, D, X;
   int i;
 
-  A1 = RSin(is.RA)*RTan(AA)*RTan(is.OB);
+  ComputeHouseTrig();
+  A1 = RSin(is.RA)*ht.TanAA*ht.TanOB;
   A1 = RAsin(A1);
   for (i = 1; i <= cSign; i++) {
     D = Mod(60.0+30.0*(real)i);
@@ -367,7 +406,7 @@ void HouseKoch()
       A2 = D/rDegQuad-3.0;
     }
     A3 = RFromD(Mod(DFromR(is.RA)+D+A2*DFromR(A1)));
-    X = Angle(RCos(A3)*RCos(is.OB)-KN*RTan(AA)*RSin(is.OB), RSin(A3));
+    X = Angle(RCos(A3)*ht.CosOB-KN*ht.TanAA*ht.SinOB, RSin(A3));
     chouse[i] = Mod(DFromR(X)+is.rSid);
   }
 }
@@ -396,6 +435,7 @@ void HouseCampanus()
   real KO, DN, X;
   int i;
 
+  ComputeHouseTrig();
   if (hRevers) {
     hRevers = 2;
     is.Asc = Mod(is.Asc -rDegHalf);
@@ -405,12 +445,12 @@ void HouseCampanus()
       KO = RFromD(300.000001-30.0*(real)i);
     else
       KO = RFromD(60.000001+30.0*(real)i);
-    DN = RAtn(RTan(KO)*RCos(AA));
+    DN = RAtn(RTan(KO)*ht.CosAA);
     if (DN < 0.0)
       DN += rPi;
     if (RSin(KO) < 0.0)
       DN += rPi;
-    X = Angle(RCos(is.RA+DN)*RCos(is.OB)-RSin(DN)*RTan(AA)*RSin(is.OB),
+    X = Angle(RCos(is.RA+DN)*ht.CosOB-RSin(DN)*ht.TanAA*ht.SinOB,
       RSin(is.RA+DN));
     chouse[i] = Mod(DFromR(X)+is.rSid);
   }
@@ -426,6 +466,7 @@ void HouseMeridian()
   real D, X;
   int i;
 
+  ComputeHouseTrig();
   if (hRevers) {
     is.Asc = Mod(is.Asc -rDegHalf);
     if(PolarMCflip) {
@@ -434,12 +475,14 @@ void HouseMeridian()
     }
   }
 
+  if (!(hRevers && PolarMCflip))
+    ComputeHouseTrigRA();
   for (i = 1; i <= cSign; i++) {
-    if (hRevers && PolarMCflip)
+    if (hRevers && PolarMCflip) {
       D = RFromD(300.0-30.0*(real)i);
-    else
-      D = RFromD(60.0+30.0*(real)i);
-    X = Angle(RCos(is.RA+D)*RCos(is.OB), RSin(is.RA+D));
+      X = Angle(RCos(is.RA+D)*ht.CosOB, RSin(is.RA+D));
+    } else
+      X = Angle(ht.rgCosRA[i]*ht.CosOB, ht.rgSinRA[i]);
     chouse[i] = Mod(DFromR(X)+is.rSid);
     if (hRevers && PolarMCflip)
       chouse[i] = Mod(chouse[i] - rDegHalf);
@@ -451,18 +494,24 @@ void HouseRegiomontanus()
   real D, X;
   int i;
 
+  ComputeHouseTrig();
   if (hRevers) {
     hRevers = 2;
     is.Asc = Mod(is.Asc -rDegHalf);
   }
 
+  if (!(hRevers && !PolarMCflip))
+    ComputeHouseTrigRA();
   for (i = 1; i <= cSign; i++) {
-    if(hRevers && !PolarMCflip)
+    if(hRevers && !PolarMCflip) {
       D = RFromD(300.0-30.0*(real)i);
-    else
+      X = Angle(RCos(is.RA+D)*ht.CosOB-RSin(D)*ht.TanAA*ht.SinOB,
+        RSin(is.RA+D));
+    } else {
       D = RFromD(60.0+30.0*(real)i);
-    X = Angle(RCos(is.RA+D)*RCos(is.OB)-RSin(D)*RTan(AA)*RSin(is.OB),
-      RSin(is.RA+D));
+      X = Angle(ht.rgCosRA[i]*ht.CosOB-RSin(D)*ht.TanAA*ht.SinOB,
+        ht.rgSinRA[i]);
+    }
     chouse[i] = Mod(DFromR(X)+is.rSid);
   }
   if (hRevers && PolarMCflip) {
@@ -518,6 +567,7 @@ void HouseMorinus()
   real D, X;
   int i;
 
+  ComputeHouseTrig();
   if (hRevers) {
     hRevers = 2;
     is.Asc = Mod(is.Asc -rDegHalf);
@@ -525,12 +575,14 @@ void HouseMorinus()
       is.MC = Mod(is.MC -rDegHalf);
   }
 
+  if (!(hRevers && PolarMCflip))
+    ComputeHouseTrigRA();
   for (i = 1; i <= cSign; i++) {
-    if (hRevers && PolarMCflip)
+    if (hRevers && PolarMCflip) {
       D = RFromD(120.0-30.0*(real)i);
-    else
-      D = RFromD(60.0+30.0*(real)i);
-    X = Angle(RCos(is.RA+D), RSin(is.RA+D)*RCos(is.OB));
+      X = Angle(RCos(is.RA+D), RSin(is.RA+D)*ht.CosOB);
+    } else
+      X = Angle(ht.rgCosRA[i], ht.rgSinRA[i]*ht.CosOB);
     chouse[i] = Mod(DFromR(X)+is.rSid);
   }
 }
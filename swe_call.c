@@ -44,24 +44,63 @@
 #include "extern.h"
 #  define d2l(x)	swe_d2l(x)
 
-/* Given an object index and a Julian Day time, get        */
-/* ecliptic longitude and latitude of the object  */
-/* and its velocity and distance from the Earth or Sun. This basically    */
-/* just calls the Placalc calculation function to actually do it, but as  */
-/* this is the one routine called from Astrolog, this is the one routine  */
-/* which has knowledge of and uses both Astrolog and Placalc definitions, */
-/* and does things such as translation to Placalc indices and formats.    */
+/* On Unix, an ephemeris pack file (-bp) is mapped into memory read-only */
+/* rather than read into allocated memory. Define NO_MMAP to not do so.  */
 
-bool FPlacalcPlanet(ind, jd, helio, obj, objalt, dir, space, altdir)
-int ind, helio;
-double jd;
-real *obj, *objalt, *dir, *space, *altdir;
+#if HPUNIX && !defined(NO_MMAP)
+#include <sys/mman.h>
+#define PACKMMAP
+#endif
+
+/* Ephemeris flag to pass along with each calculation: The JPL ephemeris */
+/* file when -bj is in effect, otherwise the default Swiss Ephemeris.    */
+
+#define LFlagEph() (us.szEphJPL != NULL ? SEFLG_JPLEPH : 0L)
+
+/* Return how many ephemeris positions have been taken from the Chebyshev */
+/* curves fitted when -Yf is in effect, and how many curves were fitted.  */
+
+void GetChebStats(plHit, plFit)
+long *plHit, *plFit;
+{
+  swe_get_cheb_stats(plHit, plFit);
+}
+
+/* Return how many ephemeris file segments were found among the decoded */
+/* segments kept in memory (see -Ys), and how many had to be decoded.   */
+
+void GetSegStats(plHit, plMiss)
+long *plHit, *plMiss;
+{
+  swe_get_seg_stats(plHit, plMiss);
+}
+
+/* Return how many true node and osculating apogee positions were found  */
+/* among the ones computed for recent dates, how many had to be computed, */
+/* and how many of those could use the Moon already computed for a date. */
+
+void GetOscStats(plHit, plCalc, plShare)
+long *plHit, *plCalc, *plShare;
+{
+  swe_get_osc_stats(plHit, plCalc, plShare);
+}
+
+/* Return how many times nutation was computed in full and interpolated */
+/* when -Yu is in effect, and how many precession matrices were reused. */
 
+void GetNutStats(plFull, plInterp, plPrec)
+long *plFull, *plInterp, *plPrec;
+{
+  swe_get_nut_stats(plFull, plInterp, plPrec);
+}
+
+/* Prepare the Swiss Ephemeris for a calculation: Tell it where to look */
+/* for ephemeris files the first time, and pass on the cache settings.  */
+
+void PlacalcInit()
 {
   static AS_BOOL path_built = FALSE;
-  int iobj;
-  long flag;
-  double jde, xx[6];
+  static byte *szJPL = NULL;
   char serr[AS_MAXCH];
   /*
    * if the function is called the first time, we build an ephemeris path
@@ -99,6 +138,24 @@ real *obj, *objalt, *dir, *space, *altdir;
     swe_set_ephe_path(serr);
     path_built = TRUE;
   }
+  /* Only tell it about a new JPL file when it changes, since doing so */
+  /* starts everything over again.                                      */
+  if (us.szEphJPL != NULL && us.szEphJPL != szJPL) {
+    swe_set_jpl_file(us.szEphJPL);
+    szJPL = us.szEphJPL;
+  }
+  swe_set_cheb_cache(us.rChebError);
+  swe_set_seg_cache(us.nSegCache);
+  swe_set_nut_cache(us.rNutError);
+}
+
+/* Return the Swiss Ephemeris body number for an object index, or -1 if */
+/* the object isn't computed by the Swiss Ephemeris.                     */
+
+int IobjPlacalc(ind, helio)
+int ind, helio;
+{
+  int iobj;
 
   if (FBetween(ind, uranLo, uranHi -1))
     iobj = ind - uranLo + SE_CUPIDO;
@@ -117,14 +174,490 @@ real *obj, *objalt, *dir, *space, *altdir;
       iobj = SE_MEAN_APOG;
   }
   else
-    return fFalse;
+    return -1;
 
   if (ind == oSun && helio)
     iobj = SE_EARTH;
-  flag = helio ? SEFLG_SPEED | SEFLG_HELCTR : SEFLG_SPEED;
+  return iobj;
+}
+
+/*
+******************************************************************************
+** Ephemeris Pack.
+******************************************************************************
+*/
+
+/* An ephemeris pack is a file tabulating the -b positions of the planets, */
+/* Chiron, asteroids, node, Lilith, and Uranians at a fixed step for each  */
+/* body, built with -Yp. Each tabulated date stores longitude, latitude,   */
+/* and distance with their speeds, and positions in between are taken     */
+/* from the cubic Hermite polynomial through the two surrounding dates.   */
+/* The file is in the byte order and word sizes of the machine which      */
+/* built it, so it can be mapped into memory and used as is.             */
+
+#define szPackMagic "AstPack1"
+#define cPackVal 6
+#define iobjPackMax (SE_FICT_OFFSET + uranHi - uranLo)
+#define rPackMinElong 3.0
+
+/* Positions of bodies close to the Sun are bent by the Sun's gravity (light */
+/* deflection), which changes them too quickly to interpolate. Between two  */
+/* tabulated dates where a body is within a few degrees of the Sun, its     */
+/* positions are left to the ephemeris.                                     */
+
+#define FPackDeflect(iobj) ((iobj) != SE_SUN && (iobj) != SE_MOON && \
+  !FBetween(iobj, SE_MEAN_NODE, SE_OSCU_APOG))
+
+/* Given the distances of such a body from the Sun at the two tabulated */
+/* dates around a date, return whether it's too close to the Sun at     */
+/* either, or passes the Sun in between.                                */
+
+#define FPackNearSun(e0, e1) (RAbs(e0) < rPackMinElong || \
+  RAbs(e1) < rPackMinElong || \
+  (((e0) < 0.0) != ((e1) < 0.0) && RAbs(e0) < 90.0 && RAbs(e1) < 90.0))
+
+typedef struct _PackHeader {
+  char szMagic[8];   /* Identifies the file, see szPackMagic.           */
+  long lOrder;       /* Set to 0x01020304 to check byte order.          */
+  int cbody;         /* Number of bodies tabulated.                     */
+  int iflag;         /* Ephemeris flag returned when building the pack. */
+  double jdStart;    /* Range covered, in Ephemeris Time.               */
+  double jdEnd;
+} PH;
+
+typedef struct _PackBody {
+  int iobj;          /* Swiss Ephemeris body number.                    */
+  long cnode;        /* Number of tabulated dates.                      */
+  double jdStart;    /* First tabulated date.                           */
+  double rStep;      /* Days between tabulated dates.                   */
+  long lOffset;      /* File offset of the first date's values.         */
+  float rErrLon;     /* Largest error found when building: arc seconds, */
+  float rErrLat;     /* arc seconds, and AU.                            */
+  float rErrDist;
+} PB;
+
+static struct {
+  byte szFile[cchSzMax]; /* Name of the pack currently loaded.      */
+  lpbyte pbData;     /* Contents of the pack file.                      */
+  long cbData;
+  bool fMapped;      /* Is pbData a mapping instead of an allocation?   */
+  PB *rgpb[iobjPackMax];
+} ep;
+
+
+/* Return the step in days at which a body is tabulated in the pack. Fast */
+/* moving bodies, and ones with large short period terms, need a smaller  */
+/* step to keep the interpolation error within a second of arc.          */
+
+real RPackStep(iobj)
+int iobj;
+{
+  switch (iobj) {
+  case SE_OSCU_APOG:
+    return 0.5;
+  case SE_MOON:
+  case SE_TRUE_NODE:
+    return 1.0;
+  case SE_MERCURY:
+    return 1.5;
+  case SE_VENUS:
+    return 3.0;
+  case SE_MARS:
+  case SE_CERES:
+  case SE_PALLAS:
+  case SE_JUNO:
+  case SE_VESTA:
+    return 4.0;
+  }
+  return 8.0;
+}
+
+
+/* Interpolate a position from the values tabulated at two dates rStep   */
+/* days apart, at fraction s of the way from the first to the second.    */
+/* The longitude is assumed to move less than 180 degrees in between.    */
+
+void HermitePack(pf, rStep, s, xx)
+float *pf;
+real rStep, s;
+double *xx;
+{
+  real h00, h10, h01, h11, d00, d10, d01, d11, p0, p1;
+  int i;
+
+  h00 = (2.0*s - 3.0)*s*s + 1.0;  h01 = 1.0 - h00;
+  h10 = ((s - 2.0)*s + 1.0)*s;    h11 = (s - 1.0)*s*s;
+  d00 = 6.0*(s - 1.0)*s / rStep;  d01 = -d00;
+  d10 = (3.0*s - 4.0)*s + 1.0;    d11 = (3.0*s - 2.0)*s;
+  for (i = 0; i < 3; i++) {
+    p0 = pf[i]; p1 = pf[cPackVal + i];
+    if (i == 0) {
+      if (p1 - p0 > 180.0)
+        p1 -= 360.0;
+      else if (p0 - p1 > 180.0)
+        p1 += 360.0;
+    }
+    xx[i] = h00*p0 + h01*p1 +
+      (h10*pf[3 + i] + h11*pf[cPackVal + 3 + i])*rStep;
+    xx[3 + i] = d00*p0 + d01*p1 + d10*pf[3 + i] + d11*pf[cPackVal + 3 + i];
+  }
+  xx[0] = Mod(xx[0]);
+}
+
+
+/* Close the ephemeris pack currently loaded, if any. */
+
+void ClosePack()
+{
+  if (ep.pbData != NULL) {
+#ifdef PACKMMAP
+    if (ep.fMapped)
+      munmap((void *)ep.pbData, ep.cbData);
+    else
+#endif
+      DeallocateHuge(ep.pbData);
+  }
+  ClearB((lpbyte)&ep, sizeof(ep));
+}
+
+
+/* Load the ephemeris pack file given with -bp, if not already loaded, */
+/* checking that it was built by a compatible machine. On failure a    */
+/* warning is printed and -bp is turned off again.                     */
+
+bool FLoadPack()
+{
+  FILE *file;
+  PH *ph;
+  PB *pb;
+  byte sz[cchSzDef];
+  int i;
+
+  if (ep.pbData != NULL && strcmp(ep.szFile, us.szEphPack) == 0)
+    return fTrue;
+  ClosePack();
+  file = FileOpen(us.szEphPack, 2);
+  if (file == NULL) {
+    sprintf(sz, "Ephemeris pack '%s' not found.", us.szEphPack);
+    goto LError;
+  }
+  fseek(file, 0L, SEEK_END);
+  ep.cbData = ftell(file);
+  if (ep.cbData >= (long)sizeof(PH)) {
+#ifdef PACKMMAP
+    ep.pbData = (lpbyte)mmap(NULL, ep.cbData, PROT_READ, MAP_SHARED,
+      fileno(file), 0);
+    if ((void *)ep.pbData == MAP_FAILED)
+      ep.pbData = NULL;
+    else
+      ep.fMapped = fTrue;
+    if (ep.pbData == NULL)
+#endif
+    {
+      ep.pbData = PAllocate(ep.cbData, fTrue, "ephemeris pack");
+      if (ep.pbData != NULL) {
+        fseek(file, 0L, SEEK_SET);
+        if (fread(ep.pbData, 1, ep.cbData, file) != ep.cbData) {
+          DeallocateHuge(ep.pbData);
+          ep.pbData = NULL;
+        }
+      }
+    }
+  }
+  fclose(file);
+  ph = (PH *)ep.pbData;
+  if (ph == NULL || strncmp(ph->szMagic, szPackMagic, 8) != 0 ||
+    ph->lOrder != 0x01020304L || ph->cbody < 0 ||
+    (long)(sizeof(PH) + ph->cbody*sizeof(PB)) > ep.cbData) {
+    sprintf(sz, "File '%s' is not an ephemeris pack built by this program.",
+      us.szEphPack);
+    goto LError;
+  }
+  pb = (PB *)(ph + 1);
+  for (i = 0; i < ph->cbody; i++, pb++)
+    if (FBetween(pb->iobj, 0, iobjPackMax-1) && pb->cnode > 1 &&
+      pb->lOffset + pb->cnode*cPackVal*(long)sizeof(float) <= ep.cbData)
+      ep.rgpb[pb->iobj] = pb;
+  sprintf(ep.szFile, "%.*s", cchSzMax-1, us.szEphPack);
+  return fTrue;
+
+LError:
+  PrintWarning(sz);
+  ClosePack();
+  us.szEphPack = NULL;
+  return fFalse;
+}
+
+
+/* Find the values of a body of the ephemeris pack tabulated at the date */
+/* on or before the given one, also returning that date and the step to  */
+/* the next date. Return NULL if the body isn't in the pack or the pack  */
+/* doesn't cover the date.                                               */
+
+float *PfPackNode(iobj, jde, pjd, prStep)
+int iobj;
+double jde, *pjd;
+real *prStep;
+{
+  PB *pb;
+  real t;
+  long i;
+
+  if (!FBetween(iobj, 0, iobjPackMax-1) || (pb = ep.rgpb[iobj]) == NULL)
+    return NULL;
+  t = (jde - pb->jdStart) / pb->rStep;
+  if (t < 0.0)
+    return NULL;
+  i = (long)t;
+  if (i >= pb->cnode - 1) {
+    if (i > pb->cnode - 1 || t > (real)i)
+      return NULL;
+    i--;
+  }
+  *pjd = pb->jdStart + (real)i*pb->rStep;
+  *prStep = pb->rStep;
+  return (float *)(ep.pbData + pb->lOffset) + i*cPackVal;
+}
+
+
+/* Interpolate the position of one body of the ephemeris pack, returning */
+/* false if the body isn't in the pack or the pack doesn't cover the date. */
+
+bool FPackBody(iobj, jde, xx)
+int iobj;
+double jde, *xx;
+{
+  float *pf;
+  double jd;
+  real rStep;
+
+  if ((pf = PfPackNode(iobj, jde, &jd, &rStep)) == NULL)
+    return fFalse;
+  HermitePack(pf, rStep, (jde - jd) / rStep, xx);
+  return fTrue;
+}
+
+
+/* Given a Swiss Ephemeris body number and a Julian Day in Ephemeris Time, */
+/* get the body's position and speeds from the ephemeris pack, in the same */
+/* form as swe_calc() returns them. Return false if the pack doesn't have  */
+/* the body, doesn't cover the date, or the body is too close to the Sun,  */
+/* in which case the caller should use the ephemeris itself.               */
+
+bool FPackPlanet(iobj, jde, xx)
+int iobj;
+double jde, *xx;
+{
+  float *pf;
+  double jd, xs[12];
+  real rStep, e0, e1;
+
+  if ((pf = PfPackNode(iobj, jde, &jd, &rStep)) == NULL)
+    return fFalse;
+  if (FPackDeflect(iobj)) {
+    if (!FPackBody(SE_SUN, jd, xs) || !FPackBody(SE_SUN, jd + rStep, xs + 6))
+      return fFalse;
+    e0 = MinDifference(xs[0], pf[0]);
+    e1 = MinDifference(xs[6], pf[cPackVal]);
+    if (FPackNearSun(e0, e1))
+      return fFalse;
+  }
+  HermitePack(pf, rStep, (jde - jd) / rStep, xx);
+  return fTrue;
+}
+
+
+/* Return whether positions should be looked up in the ephemeris pack, */
+/* which covers geocentric positions only.                             */
+
+bool FUsePack(helio)
+int helio;
+{
+  return !helio && us.szEphPack != NULL && FLoadPack();
+}
+
+
+/* Compute the position of a body for the ephemeris pack being built, */
+/* rounded to the precision the pack stores it with.                  */
+
+bool FPackCompute(iobj, jde, rgf)
+int iobj;
+double jde;
+float *rgf;
+{
+  double xx[6];
+  char serr[AS_MAXCH];
+  int i;
+
+  if (swe_calc(jde, iobj, SEFLG_SPEED | LFlagEph(), xx, serr) < 0)
+    return fFalse;
+  for (i = 0; i < cPackVal; i++)
+    rgf[i] = (float)xx[i];
+  return fTrue;
+}
+
+
+/* Build an ephemeris pack file for use with -bp, as done with the -Yp    */
+/* switch, covering the given range of years. The pack tabulates all the  */
+/* bodies -b computes, with the node and Lilith of the current settings.  */
+/* Between every two tabulated dates, the interpolated position is        */
+/* compared with the ephemeris, and the largest differences are stored in */
+/* the file and printed, as the error bound of the pack.                  */
+
+bool FWritePack(szFile, yea1, yea2)
+byte *szFile;
+int yea1, yea2;
+{
+  FILE *file;
+  PH ph;
+  PB rgpb[iobjPackMax], *pb;
+  int rgind[iobjPackMax];
+  float rgf[cPackVal*2];
+  double xx[6], xxi[6], xs[6];
+  real rElong0, rElong1;
+  byte sz[cchSzMax];
+  real r;
+  long l, cnode;
+  int ind, iobj, i;
+
+  PlacalcInit();
+  file = fopen(szFile, "wb");
+  if (file == NULL) {
+    sprintf(sz, "File %s can not be created.", szFile);
+    PrintError(sz);
+    return fFalse;
+  }
+  ClearB((lpbyte)&ph, sizeof(ph));
+  CopyRgb((byte *)szPackMagic, (byte *)ph.szMagic, 8);
+  ph.lOrder = 0x01020304L;
+  ph.jdStart = julday(1, 1, yea1, 0.0, SE_GREG_CAL);
+  ph.jdEnd = julday(1, 1, yea2 + 1, 0.0, SE_GREG_CAL);
+  ph.iflag = (int)swe_calc(ph.jdStart, SE_SUN, SEFLG_SPEED | LFlagEph(), xx,
+    sz);
+
+  /* Decide which bodies are in the pack, and where each one's values go. */
+  for (ind = oSun; ind < uranHi; ind++) {
+    iobj = IobjPlacalc(ind, fFalse);
+    if (iobj < 0)
+      continue;
+    rgind[ph.cbody] = ind;
+    pb = &rgpb[ph.cbody++];
+    ClearB((lpbyte)pb, sizeof(PB));
+    pb->iobj = iobj;
+    pb->rStep = RPackStep(iobj);
+    pb->jdStart = ph.jdStart;
+    pb->cnode = (long)((ph.jdEnd - ph.jdStart) / pb->rStep) + 2;
+  }
+  l = sizeof(PH) + ph.cbody*sizeof(PB);
+  for (i = 0; i < ph.cbody; i++) {
+    rgpb[i].lOffset = l;
+    l += rgpb[i].cnode*cPackVal*sizeof(float);
+  }
+  fwrite(&ph, sizeof(PH), 1, file);
+  fwrite(rgpb, sizeof(PB), ph.cbody, file);
+
+  /* Tabulate each body. rgf holds the values at the previous and current */
+  /* dates, so the interpolation between them can be checked.             */
+  for (i = 0; i < ph.cbody; i++) {
+    pb = &rgpb[i];
+    rElong1 = 0.0;
+    for (l = 0; l < pb->cnode; l++) {
+      r = pb->jdStart + (real)l*pb->rStep;
+      if (!FPackCompute(pb->iobj, r, rgf + cPackVal))
+        break;
+      if (FPackDeflect(pb->iobj)) {
+        if (swe_calc(r, SE_SUN, SEFLG_SPEED | LFlagEph(), xs, sz) < 0)
+          break;
+        rElong0 = rElong1;
+        rElong1 = MinDifference(xs[0], rgf[cPackVal]);
+      }
+      if (l > 0) {
+        /* Intervals where the body is close to the Sun aren't used. */
+        if (FPackDeflect(pb->iobj) && FPackNearSun(rElong0, rElong1))
+          goto LNext;
+        r -= 0.5*pb->rStep;
+        if (swe_calc(r, pb->iobj, SEFLG_SPEED | LFlagEph(), xx, sz) < 0)
+          break;
+        HermitePack(rgf, pb->rStep, 0.5, xxi);
+        r = RAbs(xxi[0] - xx[0]);
+        if (r > 180.0)
+          r = 360.0 - r;
+        pb->rErrLon = Max(pb->rErrLon, r*3600.0);
+        pb->rErrLat = Max(pb->rErrLat, RAbs(xxi[1] - xx[1])*3600.0);
+        pb->rErrDist = Max(pb->rErrDist, RAbs(xxi[2] - xx[2]));
+      }
+LNext:
+      fwrite(rgf + cPackVal, sizeof(float), cPackVal, file);
+      CopyRgb((byte *)(rgf + cPackVal), (byte *)rgf, sizeof(float)*cPackVal);
+    }
+    if (l < pb->cnode) {
+      /* Bodies the ephemeris can't compute over the whole range, such as */
+      /* asteroids without their files, are left out of the pack.         */
+      sprintf(sz, "%s can't be computed from %d to %d, left out of pack.",
+        szObjName[rgind[i]], yea1, yea2);
+      PrintWarning(sz);
+      cnode = pb->cnode;
+      pb->cnode = 0;
+      ClearB((lpbyte)rgf, sizeof(rgf));
+      for (; l < cnode; l++)
+        fwrite(rgf, sizeof(float), cPackVal, file);
+    }
+  }
+  fseek(file, sizeof(PH), SEEK_SET);
+  fwrite(rgpb, sizeof(PB), ph.cbody, file);
+  fseek(file, 0L, SEEK_END);
+  l = ftell(file);
+  fclose(file);
+
+  /* Print what was tabulated, with the largest errors found. */
+  sprintf(sz, "Ephemeris pack %s: %d to %d, %ld bytes%s.\n", szFile,
+    yea1, yea2, l, (ph.iflag & SEFLG_MOSEPH) ? ", Moshier formulas" : "");
+  PrintSz(sz);
+  PrintSz("Body       Step  Longitude  Latitude  Distance\n");
+  for (i = 0; i < ph.cbody; i++) {
+    pb = &rgpb[i];
+    if (pb->cnode == 0)
+      continue;
+    sprintf(sz, "%-9.9s %5.2f %9.4f\" %8.4f\" %9.2e\n", szObjName[rgind[i]],
+      pb->rStep, pb->rErrLon, pb->rErrLat, pb->rErrDist);
+    PrintSz(sz);
+  }
+  return fTrue;
+}
+
+/*
+******************************************************************************
+** Ephemeris Calculations.
+******************************************************************************
+*/
+
+/* Given an object index and a Julian Day time, get        */
+/* ecliptic longitude and latitude of the object  */
+/* and its velocity and distance from the Earth or Sun. This basically    */
+/* just calls the Placalc calculation function to actually do it, but as  */
+/* this is the one routine called from Astrolog, this is the one routine  */
+/* which has knowledge of and uses both Astrolog and Placalc definitions, */
+/* and does things such as translation to Placalc indices and formats.    */
+
+bool FPlacalcPlanet(ind, jd, helio, obj, objalt, dir, space, altdir)
+int ind, helio;
+double jd;
+real *obj, *objalt, *dir, *space, *altdir;
+
+{
+  int iobj;
+  long flag;
+  double jde, xx[6];
+  char serr[AS_MAXCH];
+
+  PlacalcInit();
+  if ((iobj = IobjPlacalc(ind, helio)) < 0)
+    return fFalse;
+  flag = (helio ? SEFLG_SPEED | SEFLG_HELCTR : SEFLG_SPEED) | LFlagEph();
   deltaT = swe_deltat(jd);
   jde = jd + deltaT;
-  if (swe_calc(jde, iobj, flag, xx, serr) >= 0) {
+  if ((FUsePack(helio) && FPackPlanet(iobj, jde, xx)) ||
+    swe_calc(jde, iobj, flag, xx, serr) >= 0) {
     *obj    = xx[0];
     *objalt = xx[1];
     *space  = xx[2];
@@ -164,7 +697,7 @@ real *obj, *objalt;
   byte *nomname;
 
   sprintf (iobj, "%i", ind);
-  flag = SEFLG_SWIEPH;
+  flag = us.szEphJPL != NULL ? SEFLG_JPLEPH : SEFLG_SWIEPH;
   jde = jd + swe_deltat(jd);
   if (swe_fixstar(iobj, jde, flag, xx, serr) >= 0) {
     *obj    = xx[0];
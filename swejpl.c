@@ -58,6 +58,22 @@
 #include "swejpl.h"
 
 #ifndef NO_JPL
+#if HPUNIX && !defined(NO_MMAP)
+# include <sys/mman.h>
+# define JPL_MMAP
+#endif
+
+/* the integers in the header of the file are 4 bytes long */
+#if MSDOS
+typedef long INT4;
+#else
+typedef int INT4;
+#endif
+
+/* decoded records kept in memory, besides the mapped file */
+#define JPL_NRECCACHE	4
+#define JPL_MAXCOEFFS	1500	/* doubles per record, at least */
+
 /*
  * local globals
  */
@@ -72,12 +88,22 @@ struct jpl_save {
   char ch_cnam[6*400];
   double pv[78];
   double pvsun[6];
-  double buf[1500];
+  long irecsz;		/* record size in bytes */
+  long ncoeffs;		/* doubles in a record */
+  long nrl;		/* record in buf, 0 if none */
+  double FAR *buf;	/* coefficients of record nrl */
+  char *mapp;		/* whole file if mapped, else NULL */
+  long maplen;
+  long nrc[JPL_NRECCACHE];	/* record kept in bufc[], 0 if none */
+  long lusec[JPL_NRECCACHE];	/* when last used */
+  long luse;
+  double bufc[JPL_NRECCACHE][JPL_MAXCOEFFS];
   double pc[18], vc[18], ac[18], jc[18];
   short do_km;
 };
 
 static struct jpl_save *FAR js;
+static long jpl_nhit = 0, jpl_nread = 0;
 
 static int state (double et, long *list, int do_bary, 
 		  double *pv, double *pvsun, double *nut, char *serr);
@@ -86,6 +112,8 @@ static int interp(double FAR *buf, double t, double intv, long ncfin,
 static long fsizer(char *serr);
 static void reorder(char *x, int size, int number);
 static int read_const_jpl(double *ss, short do_show, char *serr);
+static int read_int4(long *x, int number, FILE *fp);
+static double FAR *get_record(long nr, double et, char *serr);
 
 /* information about eh_ipt[] and buf[]
 DE200	DE102		  	DE403
@@ -188,9 +216,7 @@ static long fsizer(char *serr)
   if (js->do_reorder)
     reorder((char *) &js->eh_ss[0], sizeof(double), 3);
   /* ncon = number of constants */
-  fread((void *) &ncon, sizeof(long), 1, js->jplfptr);
-  if (js->do_reorder)
-    reorder((char *) &ncon, sizeof(long), 1);
+  read_int4(&ncon, 1, js->jplfptr);
   /* au = astronomical unit */
   fread((void *) &au, sizeof(double), 1, js->jplfptr);
   if (js->do_reorder)
@@ -202,18 +228,12 @@ static long fsizer(char *serr)
   /* ipt[i+0]: coefficients of planet i start at buf[ipt[i+0]-1] 
    * ipt[i+1]: number of coefficients (interpolation order - 1)
    * ipt[i+2]: number of intervals in segment */
-  fread((void *) &js->eh_ipt[0], sizeof(long), 36, js->jplfptr);
-  if (js->do_reorder)
-    reorder((char *) &js->eh_ipt[0], sizeof(long), 36);
+  read_int4(&js->eh_ipt[0], 36, js->jplfptr);
   /* numde = number of jpl ephemeris "404" with de404 */
-  fread((void *) &numde, sizeof(long), 1, js->jplfptr);
-  if (js->do_reorder)
-    reorder((char *) &numde, sizeof(long), 1);
+  read_int4(&numde, 1, js->jplfptr);
 #if 0
   /* librations */
-  fread(&lpt[0], sizeof(long), 3, js->jplfptr);
-  if (js->do_reorder)
-    reorder((char *) &lpt[0], sizeof(long), 3);
+  read_int4(&lpt[0], 3, js->jplfptr);
 #endif
   rewind(js->jplfptr);
   /*  find the number of ephemeris coefficients from the pointers */
@@ -592,15 +612,14 @@ static int state(double et, long *list, int do_bary,
 {
   int i, j, k;
   long flen, nseg, nb;
-  double FAR *buf = js->buf;
+  double FAR *buf;
   double aufac, s, t, intv;
   long nrecl, ksize;
   long nr;
   double et_mn, et_fr;
   long FAR *ipt = js->eh_ipt;
   char *ch_ttl[252];
-  static long irecsz;
-  static long nrl, lpt[3], ncoeffs;
+  long lpt[3];
   if (js->jplfptr == NULL) {
     ksize = fsizer(serr); /* the number of single precision words in a record */
     nrecl = 4;
@@ -609,8 +628,8 @@ static int state(double et, long *list, int do_bary,
 	sprintf(serr, "fsizer does not work");/**/
       return (int) ksize;
     }
-    irecsz = nrecl * ksize; 	/* record size in bytes */
-    ncoeffs = ksize / 2;	/* # of coefficients, doubles */
+    js->irecsz = nrecl * ksize; 	/* record size in bytes */
+    js->ncoeffs = ksize / 2;	/* # of coefficients, doubles */
     /* ttl = ephemeris title, e.g.
      * "JPL Planetary Ephemeris DE404/LE404
      *  Start Epoch: JED=   625296.5-3001 DEC 21 00:00:00
@@ -625,9 +644,7 @@ static int state(double et, long *list, int do_bary,
     if (js->do_reorder)
       reorder((char *) &js->eh_ss[0], sizeof(double), 3);
     /* ncon = number of constants */
-    fread((void *) &js->eh_ncon, sizeof(long), 1, js->jplfptr);
-    if (js->do_reorder)
-      reorder((char *) &js->eh_ncon, sizeof(long), 1);
+    read_int4(&js->eh_ncon, 1, js->jplfptr);
     /* au = astronomical unit */
     fread((void *) &js->eh_au, sizeof(double), 1, js->jplfptr);
     if (js->do_reorder)
@@ -639,25 +656,19 @@ static int state(double et, long *list, int do_bary,
     /* ipt[i+0]: coefficients of planet i start at buf[ipt[i+0]-1] 
      * ipt[i+1]: number of coefficients (interpolation order - 1)
      * ipt[i+2]: number of intervals in segment */
-    fread((void *) &ipt[0], sizeof(long), 36, js->jplfptr);
-    if (js->do_reorder)
-      reorder((char *) &ipt[0], sizeof(long), 36);
+    read_int4(&ipt[0], 36, js->jplfptr);
     /* numde = number of jpl ephemeris "404" with de404 */
-    fread((void *) &js->eh_denum, sizeof(long), 1, js->jplfptr);
-    if (js->do_reorder)
-      reorder((char *) &js->eh_denum, sizeof(long), 1);
-    fread((void *) &lpt[0], sizeof(long), 3, js->jplfptr);
-    if (js->do_reorder)
-      reorder((char *) &lpt[0], sizeof(long), 3);
+    read_int4(&js->eh_denum, 1, js->jplfptr);
+    read_int4(&lpt[0], 3, js->jplfptr);
     /* cval[]:  other constants in next record */
-    fseek(js->jplfptr, 1L * irecsz, 0);
+    fseek(js->jplfptr, 1L * js->irecsz, 0);
     fread((void *) &js->eh_cval[0], sizeof(double), 400, js->jplfptr);
     if (js->do_reorder)
       reorder((char *) &js->eh_cval[0], sizeof(double), 400);
-    fseek(js->jplfptr, 2L * irecsz, 0);
+    fseek(js->jplfptr, 2L * js->irecsz, 0);
     for (i = 0; i < 3; ++i) 
       ipt[i + 36] = lpt[i];
-    nrl = 0;
+    js->nrl = 0;
     /* is file length correct? */
     /* file length */
     if (fseek(js->jplfptr, sizeof(char), SEEK_END) != 0) {
@@ -702,6 +713,15 @@ static int state(double et, long *list, int do_bary,
       }
       return(ERR);
     }
+#ifdef JPL_MMAP
+    /* records are taken from the mapped file, without reading */
+    js->mapp = (char *) mmap(NULL, (size_t) flen, PROT_READ, MAP_SHARED, 
+			     fileno(js->jplfptr), 0);
+    if (js->mapp == (char *) MAP_FAILED)
+      js->mapp = NULL;
+    else
+      js->maplen = flen;
+#endif
   }
   if (list == NULL) 
     return 0;
@@ -720,24 +740,14 @@ static int state(double et, long *list, int do_bary,
   if (et_mn == js->eh_ss[1]) 
     --nr;	/* end point of ephemeris, use last record */
   t = (et_mn - ((nr - 2) * js->eh_ss[2] + js->eh_ss[0]) + et_fr) / js->eh_ss[2];
-  /* read correct record if not in core */
-  if (nr != nrl) {
-    nrl = nr;
-    if (fseek(js->jplfptr, nr * irecsz, 0) != 0) {
-      if (serr != NULL) 
-	sprintf(serr, "Read error in JPL eph. at %f\n", et);
+  /* get correct record if not in core */
+  if (nr != js->nrl) {
+    if ((buf = get_record(nr, et, serr)) == NULL)
       return ERR;
-    }
-    for (k = 1; k <= ncoeffs; ++k) {
-      if ( fread((void *) &buf[k - 1], sizeof(double), 1, js->jplfptr) != 1) {
-	if (serr != NULL) 
-	  sprintf(serr, "Read error in JPL eph. at %f\n", et);
-	return ERR;
-      }
-      if (js->do_reorder)
-	reorder((char *) &buf[k-1], sizeof(double), 1);
-    }
-  }
+    js->buf = buf;
+    js->nrl = nr;
+  } else
+    buf = js->buf;
   if (js->do_km) {
     intv = js->eh_ss[2] * 86400.;
     aufac = 1.;
@@ -819,6 +829,64 @@ static int read_const_jpl(double *ss, short do_show, char *serr)
   return OK;
 } 
 
+/*
+ * returns the coefficients of record nr: in place in the mapped file 
+ * if they need no reordering, else decoded into one of the kept 
+ * records, replacing the least recently used one if nr isn't among them.
+ */
+static double FAR *get_record(long nr, double et, char *serr)
+{
+  int i, iold = 0;
+  double FAR *rec;
+  if (js->mapp != NULL && !js->do_reorder 
+      && (nr + 1) * js->irecsz <= js->maplen) {
+    jpl_nhit++;
+    return (double FAR *) (js->mapp + nr * js->irecsz);
+  }
+  for (i = 0; i < JPL_NRECCACHE; i++) {
+    if (js->nrc[i] == nr) {
+      js->lusec[i] = ++js->luse;
+      jpl_nhit++;
+      return js->bufc[i];
+    }
+    if (js->lusec[i] < js->lusec[iold])
+      iold = i;
+  }
+  rec = js->bufc[iold];
+  js->nrc[iold] = 0;
+  if (js->mapp != NULL && (nr + 1) * js->irecsz <= js->maplen) {
+    memcpy((void *) rec, (void *) (js->mapp + nr * js->irecsz), 
+	   js->ncoeffs * sizeof(double));
+  } else if (fseek(js->jplfptr, nr * js->irecsz, 0) != 0
+      || fread((void *) rec, sizeof(double), js->ncoeffs, js->jplfptr) 
+	 != (size_t) js->ncoeffs) {
+    if (serr != NULL) 
+      sprintf(serr, "Read error in JPL eph. at %f\n", et);
+    return NULL;
+  }
+  if (js->do_reorder)
+    reorder((char *) rec, sizeof(double), js->ncoeffs);
+  js->nrc[iold] = nr;
+  js->lusec[iold] = ++js->luse;
+  jpl_nread++;
+  return rec;
+}
+
+/* reads 4 byte integers from the file header into longs */
+static int read_int4(long *x, int number, FILE *fp)
+{
+  int i;
+  INT4 n;
+  for (i = 0; i < number; i++) {
+    if (fread((void *) &n, 4, 1, fp) != 1)
+      return ERR;
+    if (js->do_reorder)
+      reorder((char *) &n, 4, 1);
+    x[i] = n;
+  }
+  return OK;
+}
+
 static void reorder(char *x, int size, int number) 
 {
   int i, j;
@@ -837,6 +905,10 @@ static void reorder(char *x, int size, int number)
 void swi_close_jpl_file(void)
 {
   if (js != NULL) {
+#ifdef JPL_MMAP
+    if (js->mapp != NULL)
+      munmap((void *) js->mapp, (size_t) js->maplen);
+#endif
     if (js->jplfptr != NULL)
       fclose(js->jplfptr);
     if (js->jplfname != NULL) 
@@ -883,6 +955,13 @@ long swi_get_jpl_denum()
 {
   return js->eh_denum;
 }
+
+/* number of times a record was found in memory, and read from file */
+void swi_get_jpl_stats(long *nhit, long *nread)
+{
+  *nhit = jpl_nhit;
+  *nread = jpl_nread;
+}
 #endif	/* NO_JPL */
 
 /* rotation angles for conversion from IERS to FK5 */
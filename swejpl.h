@@ -86,5 +86,8 @@ extern int swi_open_jpl_file(double *ss, char *fname, char *fpath, char *serr);
 
 extern long swi_get_jpl_denum(void);
 
+/* number of times a record was found in memory, and read from file */
+extern void swi_get_jpl_stats(long *nhit, long *nread);
+
 extern void swi_IERS_FK5(double *xin, double *xout, int dir);
 
@@ -154,6 +154,11 @@
  *                  pol[0] longitude, pol[1] latitude, pol[2] radius
  * swi_moshmoon2( JD, pol );
  *
+ * swi_moshmoon2_batch() does the same for up to MOSH_NBATCH dates at
+ * once.  The evaluation keeps all intermediate values in a struct
+ * moon_args per date, so the code is reentrant; the perturbation
+ * tables are stepped through once for all dates.
+ *
  * - S. L. Moshier, August, 1991
  * DE200 fit: July, 1992
  * DE404 fit: October, 1995
@@ -166,17 +171,40 @@
 #include "sweph.h"
 #include "swephlib.h"
 
-static void mean_elements(void);
+/* intermediate values of the lunar theory for one date */
+struct moon_args {
+  double T, T2;			/* Julian centuries from J2000 */
+  double LP, M, MP, D, NF;	/* mean elements, arc seconds */
+#ifndef NO_MOSHIER
+  double Ve, Ea, Ma, Ju, Sa;	/* mean longitudes of planets */
+  double f;			/* 18 Ve - 16 Ea */
+  double l, l1, l2, l3, l4;	/* longitude terms in T^0 .. T^4 */
+  double B;			/* latitude */
+  double moonpol[3];
+#endif
+};
+
+#ifndef NO_MOSHIER
+/* sin and cos of multiples of D, M, MP, NF, one column per date */
+struct moon_sscc {
+  double ss[4][6][MOSH_NBATCH];
+  double cc[4][6][MOSH_NBATCH];
+};
+#endif
+
+static void mean_elements(struct moon_args *ma);
 static double mods3600(double x);
 #ifndef NO_MOSHIER
 static void ecldat_equ2000(double tjd, double *xpm);
-static void chewm(short *pt, int nlines, int nangles, 
-  				     int typflg, double *ans );
-static void sscc(int k, double arg, int n );
-static void moon1(void);
-static void moon2(void);
-static void moon3(void);
-static void moon4(void);
+static void chewm(short *pt, int nlines, int nangles, int typflg,
+		  struct moon_sscc *sc, struct moon_args *ma, int nj);
+static void sscc(struct moon_sscc *sc, int l, int k, double arg, int n);
+static void moon1(struct moon_args *ma, struct moon_sscc *sc, int nj);
+static void moon1_t2(struct moon_args *ma);
+static void moon1_t1(struct moon_args *ma);
+static void moon2(struct moon_args *ma);
+static void moon3(struct moon_args *ma, struct moon_sscc *sc, int nj);
+static void moon4(struct moon_args *ma);
 #endif
 
 /* The following coefficients were calculated by a simultaneous least
@@ -557,61 +585,40 @@ Multiply by T^2
  2,-2, 0,-1,   -2,
 };
 
-/* The following times are set up by update() and refer
- * to the same instant.  The distinction between them
- * is required by altaz().
- */
-static double FAR ss[5][8]; 
-static double FAR cc[5][8];
-
-static double l;		/* Moon's ecliptic longitude */
-static double B;		/* Ecliptic latitude */
-
-static double moonpol[3];
-#endif /* NO_MOSHIER */
-
-/* Orbit calculation begins.
- */
-static double LP;
-static double M;
-static double MP;
-static double D;
-static double NF;
-static double T;
-static double T2;
-
-#ifndef NO_MOSHIER
-static double T3;
-static double T4;
-static double f;
-static double g;
-static double Ve;
-static double Ea;
-static double Ma;
-static double Ju;
-static double Sa;
-static double cg;
-static double sg;
-static double l1;
-static double l2;
-static double l3;
-static double l4;
-
 /* Calculate geometric coordinates of Moon
  * without light time or nutation correction.
  */
 int swi_moshmoon2(double J, double *pol)
 {
-int i;
-T = (J-J2000)/36525.0;
-T2 = T*T;
-mean_elements();
-moon1();
-moon2();
-moon3();
-moon4();
-for( i=0; i<3; i++ ) 
-  pol[i] = moonpol[i];
+return swi_moshmoon2_batch(&J, 1, pol);
+}
+
+/* Same as swi_moshmoon2(), for nj <= MOSH_NBATCH dates.
+ * J		array of nj dates
+ * pol		return array of 3 * nj doubles, polar coordinates
+ *		of ecliptic of date for each date
+ */
+int swi_moshmoon2_batch(double *J, int nj, double *pol)
+{
+struct moon_args ma[MOSH_NBATCH];
+struct moon_sscc sc;
+int i, l;
+if (nj > MOSH_NBATCH)
+  return(ERR);
+for (l = 0; l < nj; l++) {
+  ma[l].T = (J[l]-J2000)/36525.0;
+  ma[l].T2 = ma[l].T*ma[l].T;
+  mean_elements(&ma[l]);
+}
+moon1(ma, &sc, nj);
+for (l = 0; l < nj; l++)
+  moon2(&ma[l]);
+moon3(ma, &sc, nj);
+for (l = 0; l < nj; l++) {
+  moon4(&ma[l]);
+  for( i=0; i<3; i++ ) 
+    pol[l*3+i] = ma[l].moonpol[i];
+}
 return(0);
 }
 
@@ -622,24 +629,15 @@ return(0);
  */
 int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpmret, char *serr) 
 {
-  int i;
-  double a, b, x1[6], x2[6], t;
+  int i, retc;
   double xx[6], *xpm;
   struct plan_data *pdp = &swed.pldat[SEI_MOON];
-  char s[AS_MAXCH];
   if (do_save)
     xpm = pdp->x;
   else
     xpm = xx;
-  if (tjd < MOSHLUEPH_START || tjd > MOSHLUEPH_END) {
-    if (serr != NULL) {
-      sprintf(s, "jd %f beyond Moshier eph. limits %f and %f ",
-		    tjd, MOSHLUEPH_START, MOSHLUEPH_END);
-      if (strlen(serr) + strlen(s) < AS_MAXCH)
-	strcat(serr, s);
-    }
-    return(ERR);
-  }  
+  if (tjd < MOSHLUEPH_START || tjd > MOSHLUEPH_END)
+    return swi_moshmoon_list(&tjd, 1, xpm, serr);
   /* if moon has already been computed */
   if (tjd == pdp->teval && pdp->iephe == SEFLG_MOSEPH) {
     if (xpmret != NULL)
@@ -647,48 +645,88 @@ int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpmret, char *serr)
 	xpmret[i] = pdp->x[i];
     return(OK);
   }
-  /* else compute moon */
-  swi_moshmoon2(tjd, xpm);
+  /* else compute moon, and two more positions for the speed */
+  retc = swi_moshmoon_list(&tjd, 1, xpm, serr);
   if (do_save) {
     pdp->teval = tjd;
     pdp->xflgs = -1;
     pdp->iephe = SEFLG_MOSEPH;
   }
-  /* Moshier moon is referred to ecliptic of date. But we need 
-   * equatorial positions for several reasons.
-   * e.g. computation of earth from emb and moon
-   *                  of heliocentric moon
-   * Besides, this helps to keep the program structure simpler 
-   */
-  ecldat_equ2000(tjd, xpm);
-  /* speed */
-  /* from 2 other positions. */
-  /* one would be good enough for computation of osculating node, 
-   * but not for osculating apogee */
-  t = tjd + MOON_SPEED_INTV;
-  swi_moshmoon2(t, x1);
-  ecldat_equ2000(t, x1);
-  t = tjd - MOON_SPEED_INTV;
-  swi_moshmoon2(t, x2);
-  ecldat_equ2000(t, x2);
-  for (i = 0; i <= 2; i++) {
+  if (xpmret != NULL)
+    for (i = 0; i <= 5; i++)
+      xpmret[i] = xpm[i];
+  return(retc);
+}
+
+/* Moshier's moon for several dates, with one batch of lunar
+ * series for all of them. nothing is saved.
+ * tjd		array of nt julian days, nt <= MOSH_NBATCH / 3
+ * xpm		return array of 6 * nt doubles, position and speed
+ *		vectors of each date, as from swi_moshmoon()
+ * serr		pointer to error string
+ */
+int swi_moshmoon_list(double *tjd, int nt, double *xpm, char *serr)
+{
+  int i, k;
+  double a, b, x1[6], x2[6];
+  double tb[MOSH_NBATCH], pol[3 * MOSH_NBATCH];
+  char s[AS_MAXCH];
+  if (nt * 3 > MOSH_NBATCH)
+    return(ERR);
+  for (k = 0; k < nt; k++) {
+    if (tjd[k] < MOSHLUEPH_START || tjd[k] > MOSHLUEPH_END) {
+      if (serr != NULL) {
+	sprintf(s, "jd %f beyond Moshier eph. limits %f and %f ",
+		      tjd[k], MOSHLUEPH_START, MOSHLUEPH_END);
+	if (strlen(serr) + strlen(s) < AS_MAXCH)
+	  strcat(serr, s);
+      }
+      return(ERR);
+    }  
+    /* the moon, and two more positions for the speed */
+    tb[k*3] = tjd[k];
+    tb[k*3+1] = tjd[k] + MOON_SPEED_INTV;
+    tb[k*3+2] = tjd[k] - MOON_SPEED_INTV;
+  }
+  swi_moshmoon2_batch(tb, nt * 3, pol);
+  for (k = 0; k < nt; k++, xpm += 6) {
+    for (i = 0; i <= 2; i++) {
+      xpm[i] = pol[k*9+i];
+      x1[i] = pol[k*9+3+i];
+      x2[i] = pol[k*9+6+i];
+    }
+    /* Moshier moon is referred to ecliptic of date. But we need 
+     * equatorial positions for several reasons.
+     * e.g. computation of earth from emb and moon
+     *                  of heliocentric moon
+     * Besides, this helps to keep the program structure simpler 
+     */
+    ecldat_equ2000(tb[k*3], xpm);
+    /* speed */
+    /* from 2 other positions. */
+    /* one would be good enough for computation of osculating node, 
+     * but not for osculating apogee */
+    ecldat_equ2000(tb[k*3+1], x1);
+    ecldat_equ2000(tb[k*3+2], x2);
+    for (i = 0; i <= 2; i++) {
 #if 0
-    xpm[i+3] = (x1[i] - x2[i]) / MOON_SPEED_INTV / 2;
+      xpm[i+3] = (x1[i] - x2[i]) / MOON_SPEED_INTV / 2;
 #else
-    b = (x1[i] - x2[i]) / 2;
-    a = (x1[i] + x2[i]) / 2 - xpm[i];
-    xpm[i+3] = (2 * a + b) / MOON_SPEED_INTV;
+      b = (x1[i] - x2[i]) / 2;
+      a = (x1[i] + x2[i]) / 2 - xpm[i];
+      xpm[i+3] = (2 * a + b) / MOON_SPEED_INTV;
 #endif
+    }
   }
-  if (xpmret != NULL)
-    for (i = 0; i <= 5; i++)
-      xpmret[i] = xpm[i];
   return(OK);
 }
 
-static void moon1()
+static void moon1(struct moon_args *ma, struct moon_sscc *sc, int nj)
 {
-double a;
+int i;
+for (i = 0; i < nj; i++) {
+  double T = ma[i].T, T2 = ma[i].T2;
+  double Ve, Ea, Ma, Ju, Sa;
 /* Mean longitudes of planets (Laskar, Bretagnon) */
 Ve = mods3600( 210664136.4335482 * T + 655127.283046 );
 Ve += ((((((((
@@ -717,16 +755,37 @@ Ju = mods3600( 10925660.428608 * T +  123665.342120 );
 Ju += (1.543273e-5*T - 3.06037836351e-1)*T2;
 Sa = mods3600( 4399609.65932 * T + 180278.89694 );
 Sa += (( 4.475946e-8*T - 6.874806E-5 ) * T + 7.56161437443E-1)*T2;
-sscc( 0, STR*D, 6 );
-sscc( 1, STR*M,  4 );
-sscc( 2, STR*MP, 4 );
-sscc( 3, STR*NF, 4 );
-moonpol[0] = 0.0;
-moonpol[1] = 0.0;
-moonpol[2] = 0.0;
+  ma[i].Ve = Ve;
+  ma[i].Ea = Ea;
+  ma[i].Ma = Ma;
+  ma[i].Ju = Ju;
+  ma[i].Sa = Sa;
+  sscc( sc, i, 0, STR*ma[i].D, 6 );
+  sscc( sc, i, 1, STR*ma[i].M,  4 );
+  sscc( sc, i, 2, STR*ma[i].MP, 4 );
+  sscc( sc, i, 3, STR*ma[i].NF, 4 );
+  ma[i].moonpol[0] = 0.0;
+  ma[i].moonpol[1] = 0.0;
+  ma[i].moonpol[2] = 0.0;
+}
 /* terms in T^2, scale 1.0 = 10^-5" */
-chewm( LRT2, NLRT2, 4, 2, moonpol );
-chewm( BT2, NBT2, 4, 4, moonpol );
+chewm( LRT2, NLRT2, 4, 2, sc, ma, nj );
+chewm( BT2, NBT2, 4, 4, sc, ma, nj );
+for (i = 0; i < nj; i++)
+  moon1_t2(&ma[i]);
+/* terms in T */
+chewm( BT, NBT, 4, 4, sc, ma, nj );
+chewm( LRT, NLRT, 4, 1, sc, ma, nj );
+for (i = 0; i < nj; i++)
+  moon1_t1(&ma[i]);
+}
+
+static void moon1_t2(struct moon_args *ma)
+{
+double T = ma->T, LP = ma->LP, M = ma->M, MP = ma->MP, D = ma->D, NF = ma->NF;
+double Ve = ma->Ve, Ea = ma->Ea, Ma = ma->Ma, Ju = ma->Ju, Sa = ma->Sa;
+double *moonpol = ma->moonpol;
+double a, f, g, cg, sg, l, l1, l2, l3, l4;
 f = 18 * Ve - 16 * Ea;
 g = STR*(f - MP );  /* 18V - 16E - l */
 cg = cos(g);
@@ -802,10 +861,22 @@ g = STR*(2.0*D - M - MP);
 moonpol[2] +=  -0.1910 * cos( g ) * T;
 moonpol[1] *= T;
 moonpol[2] *= T;
-/* terms in T */
 moonpol[0] = 0.0;
-chewm( BT, NBT, 4, 4, moonpol );
-chewm( LRT, NLRT, 4, 1, moonpol );
+ma->f = f;
+ma->l = l;
+ma->l1 = l1;
+ma->l2 = l2;
+ma->l3 = l3;
+ma->l4 = l4;
+}
+
+static void moon1_t1(struct moon_args *ma)
+{
+double T = ma->T, LP = ma->LP, MP = ma->MP, D = ma->D, NF = ma->NF;
+double Ve = ma->Ve, Ea = ma->Ea, Ma = ma->Ma, Ju = ma->Ju, f = ma->f;
+double *moonpol = ma->moonpol;
+double a, g, cg, sg, l = ma->l, l1 = ma->l1;
+a = 4.0*Ea - 8.0*Ma + 3.0*Ju;
 g = STR*(f - MP - NF - 2355767.6); /* 18V - 16E - l - F */
 moonpol[1] +=  -1127. * sin(g);
 g = STR*(f - MP + NF - 235353.6); /* 18V - 16E - l + F */
@@ -880,10 +951,15 @@ l1 += moonpol[0];
 a = 0.1 * T; /* set amplitude scale of 1.0 = 10^-4 arcsec */
 moonpol[1] *= a;
 moonpol[2] *= a;
+ma->l = l;
+ma->l1 = l1;
 }
 
-static void moon2()
+static void moon2(struct moon_args *ma)
 {
+double LP = ma->LP, MP = ma->MP, D = ma->D, NF = ma->NF;
+double Ve = ma->Ve, Ea = ma->Ea, Ma = ma->Ma, Ju = ma->Ju, f = ma->f;
+double g, l = ma->l, B;
 /* terms in T^0 */
 g = STR*(2*(Ea-Ju+D)-MP+648431.172);
 l += 1.14307 * sin(g);
@@ -957,24 +1033,35 @@ g = STR*(LP - 2.0*NF + 3.2);
 B +=  0.32623 * sin(g);
 g = STR*(LP - 2.0*D + 2.5);
 B +=  0.29855 * sin(g);
+ma->l = l;
+ma->B = B;
 }
 
-static void moon3()
+static void moon3(struct moon_args *ma, struct moon_sscc *sc, int nj)
 {
+int i;
+double T, l;
 /* terms in T^0 */
-moonpol[0] = 0.0;
-chewm( LR, NLR, 4, 1, moonpol );
-chewm( MB, NMB, 4, 3, moonpol );
-l += (((l4 * T + l3) * T + l2) * T + l1) * T * 1.0e-5;
-moonpol[0] = LP + l + 1.0e-4 * moonpol[0];
-moonpol[1] = 1.0e-4 * moonpol[1] + B;
-moonpol[2] = 1.0e-4 * moonpol[2] + 385000.52899; /* kilometers */
+for (i = 0; i < nj; i++)
+  ma[i].moonpol[0] = 0.0;
+chewm( LR, NLR, 4, 1, sc, ma, nj );
+chewm( MB, NMB, 4, 3, sc, ma, nj );
+for (i = 0; i < nj; i++) {
+  double *moonpol = ma[i].moonpol;
+  T = ma[i].T;
+  l = ma[i].l;
+  l += (((ma[i].l4 * T + ma[i].l3) * T + ma[i].l2) * T + ma[i].l1) * T * 1.0e-5;
+  moonpol[0] = ma[i].LP + l + 1.0e-4 * moonpol[0];
+  moonpol[1] = 1.0e-4 * moonpol[1] + ma[i].B;
+  moonpol[2] = 1.0e-4 * moonpol[2] + 385000.52899; /* kilometers */
+}
 }
 
 /* Compute final ecliptic polar coordinates
  */
-static void moon4()
+static void moon4(struct moon_args *ma)
 {
+double *moonpol = ma->moonpol;
 moonpol[2] /= AUNIT / 1000;
 moonpol[0] = STR * mods3600( moonpol[0] );
 moonpol[1] = STR * moonpol[1];
@@ -989,15 +1076,12 @@ moonpol[1] = STR * moonpol[1];
 int swi_mean_node(double J, double *pol, char *serr)
 {
 #if 0
-  double a, b, c;
+  double a, b, c, T, T2, T3, T4;
 #endif
+  struct moon_args ma;
   char s[AS_MAXCH];
-  T = (J-J2000)/36525.0;
-  T2 = T*T;
-#ifndef NO_MOSHIER
-  T3 = T*T2;
-  T4 = T2*T2;
-#endif /* NO_MOSHIER */
+  ma.T = (J-J2000)/36525.0;
+  ma.T2 = ma.T*ma.T;
   /* with elements from swi_moshmoon2(), which are fitted to jpl-ephemeris */
   if (J < MOSHLUEPH_START || J > MOSHLUEPH_END) {
     if (serr != NULL) {
@@ -1008,9 +1092,9 @@ int swi_mean_node(double J, double *pol, char *serr)
     }
     return ERR;
   }
-  mean_elements();
+  mean_elements(&ma);
   /* longitude */
-  pol[0] = swi_mod2PI((LP - NF) * STR);
+  pol[0] = swi_mod2PI((ma.LP - ma.NF) * STR);
   /* latitude */
   pol[1] = 0.0;
   /* distance */
@@ -1019,6 +1103,7 @@ int swi_mean_node(double J, double *pol, char *serr)
 #if 0
   a = pol[0];
   /* Chapront, according to Meeus, German, p. 339 */
+  T = ma.T; T2 = ma.T2; T3 = T*T2; T4 = T2*T2;
   pol[0] = 125.0445550 - 1934.1361849 * T + 0.0020762 * T2 +
 	   T3 / 467410 - T4 / 60616000;
   pol[0] = swi_mod2PI(pol[0] * DEGTORAD);
@@ -1041,15 +1126,13 @@ int swi_mean_apog(double J, double *pol, char *serr)
   int i;
   double a, b;
   double x[3];
+  double T, T2, T3, T4;
 #endif
   double node;
+  struct moon_args ma;
   char s[AS_MAXCH];
-  T = (J-J2000)/36525.0;
-  T2 = T*T;
-#ifndef NO_MOSHIER
-  T3 = T*T2;
-  T4 = T2*T2;
-#endif
+  ma.T = (J-J2000)/36525.0;
+  ma.T2 = ma.T*ma.T;
   /* with elements from swi_moshmoon2(), which are fitted to jpl-ephemeris */
   if (J < MOSHLUEPH_START || J > MOSHLUEPH_END) {
     if (serr != NULL) {
@@ -1060,11 +1143,12 @@ int swi_mean_apog(double J, double *pol, char *serr)
     }
     return(ERR);
   }
-  mean_elements();
-  pol[0] = swi_mod2PI((LP - MP) * STR + PI);
+  mean_elements(&ma);
+  pol[0] = swi_mod2PI((ma.LP - ma.MP) * STR + PI);
 #if 0
   a = pol[0];
   /* Chapront, according to Meeus, German, p. 339 */
+  T = ma.T; T2 = ma.T2; T3 = T*T2; T4 = T2*T2;
   pol[0] = 83.3532430 + 4069.0137111 * T - 0.0103238 * T2
 	   - T3 / 80053 + T4 / 18999000;
   pol[0] = swi_mod2PI(pol[0] * DEGTORAD + PI);
@@ -1099,7 +1183,7 @@ int swi_mean_apog(double J, double *pol, char *serr)
    * We neglect this influence.
    */
   /* apogee is now projected onto ecliptic */
-  node = (LP - NF) * STR;
+  node = (ma.LP - ma.NF) * STR;
   pol[0] = swi_mod2PI(pol[0] - node);
   swi_polcart(pol, pol);
   swi_coortrf(pol, pol, -MOON_MEAN_INCL * DEGTORAD);
@@ -1128,36 +1212,57 @@ int swi_mean_apog(double J, double *pol, char *serr)
 }
 
 #ifndef NO_MOSHIER
-/* Program to step through the perturbation table
+/* Program to step through the perturbation table,
+ * for nj dates at a time. The sums are kept in one
+ * column per date and added to ma[].moonpol at the end.
  */
-static void chewm(short *pt, int nlines, int nangles, int typflg, double *ans )
+static void chewm(short *pt, int nlines, int nangles, int typflg,
+		  struct moon_sscc *sc, struct moon_args *ma, int nj)
 {
-  int i, j, k, k1, m;
-  double cu, su, cv, sv, ff;
+  int i, j, k, k1, m, l;
+  double *pu, *pc, ff, amp;
+  double cv[MOSH_NBATCH], sv[MOSH_NBATCH], ans[3][MOSH_NBATCH];
+  for (l = 0; l < nj; l++) {
+    ans[0][l] = ma[l].moonpol[0];
+    ans[1][l] = ma[l].moonpol[1];
+    ans[2][l] = ma[l].moonpol[2];
+  }
   for( i=0; i<nlines; i++ ) {
     k1 = 0;
-    sv = 0.0;
-    cv = 0.0;
+    for (l = 0; l < nj; l++) {
+      sv[l] = 0.0;
+      cv[l] = 0.0;
+    }
     for( m=0; m<nangles; m++ ) {
       j = *pt++; /* multiple angle factor */
       if( j ) {
 	k = j;
 	if( j < 0 ) k = -k; /* make angle factor > 0 */
 	/* sin, cos (k*angle) from lookup table */
-	su = ss[m][k-1];
-	cu = cc[m][k-1];
-	if( j < 0 ) su = -su; /* negative angle factor */
+	pu = sc->ss[m][k-1];
+	pc = sc->cc[m][k-1];
 	if( k1 == 0 ) {
 	  /* Set sin, cos of first angle. */
-	  sv = su;
-	  cv = cu;
+	  for (l = 0; l < nj; l++) {
+	    sv[l] = j < 0 ? -pu[l] : pu[l]; /* negative angle factor */
+	    cv[l] = pc[l];
+	  }
 	  k1 = 1;
 	}
-	else {
+	else if( j < 0 ) {
 	  /* Combine angles by trigonometry. */
-	  ff =  su*cv + cu*sv;
-	  cv = cu*cv - su*sv;
-	  sv = ff;
+	  for (l = 0; l < nj; l++) {
+	    ff =  -pu[l]*cv[l] + pc[l]*sv[l];
+	    cv[l] = pc[l]*cv[l] - -pu[l]*sv[l];
+	    sv[l] = ff;
+	  }
+	}
+	else {
+	  for (l = 0; l < nj; l++) {
+	    ff =  pu[l]*cv[l] + pc[l]*sv[l];
+	    cv[l] = pc[l]*cv[l] - pu[l]*sv[l];
+	    sv[l] = ff;
+	  }
 	}
       }
     }
@@ -1168,54 +1273,76 @@ static void chewm(short *pt, int nlines, int nangles, int typflg, double *ans )
     case 1:
       j = *pt++;
       k = *pt++;
-      ans[0] += (10000.0 * j  + k) * sv;
+      amp = 10000.0 * j  + k;
+      for (l = 0; l < nj; l++)
+	ans[0][l] += amp * sv[l];
       j = *pt++;
       k = *pt++;
-      if( k ) ans[2] += (10000.0 * j  + k) * cv;
+      if( k ) {
+	amp = 10000.0 * j  + k;
+	for (l = 0; l < nj; l++)
+	  ans[2][l] += amp * cv[l];
+      }
       break;
     /* longitude and radius */
     case 2:
       j = *pt++;
       k = *pt++;
-      ans[0] += j * sv;
-      ans[2] += k * cv;
+      for (l = 0; l < nj; l++) {
+	ans[0][l] += j * sv[l];
+	ans[2][l] += k * cv[l];
+      }
       break;
     /* large latitude */
     case 3:
       j = *pt++;
       k = *pt++;
-      ans[1] += ( 10000.0*j + k)*sv;
+      amp = 10000.0*j + k;
+      for (l = 0; l < nj; l++)
+	ans[1][l] += amp*sv[l];
       break;
     /* latitude */
     case 4:
       j = *pt++;
-      ans[1] += j * sv;
+      for (l = 0; l < nj; l++)
+	ans[1][l] += j * sv[l];
       break;
     }
   }
+  for (l = 0; l < nj; l++) {
+    ma[l].moonpol[0] = ans[0][l];
+    ma[l].moonpol[1] = ans[1][l];
+    ma[l].moonpol[2] = ans[2][l];
+  }
 }
 
 /* Prepare lookup table of sin and cos ( i*Lj )
- * for required multiple angles
+ * for required multiple angles, in column l of sc
  */
-static void sscc(int k, double arg, int n )
+static void sscc(struct moon_sscc *sc, int l, int k, double arg, int n)
 {
   double cu, su, cv, sv, s;
   int i;
   su = sin(arg);
   cu = cos(arg);
-  ss[k][0] = su;			/* sin(L) */
-  cc[k][0] = cu;			/* cos(L) */
+  sc->ss[k][0][l] = su;			/* sin(L) */
+  sc->cc[k][0][l] = cu;			/* cos(L) */
   sv = 2.0*su*cu;
   cv = cu*cu - su*su;
-  ss[k][1] = sv;			/* sin(2L) */
-  cc[k][1] = cv;
+  sc->ss[k][1][l] = sv;			/* sin(2L) */
+  sc->cc[k][1][l] = cv;
   for( i=2; i<n; i++ ) {
     s =  su*cv + cu*sv;
     cv = cu*cv - su*sv;
     sv = s;
-    ss[k][i] = sv;		/* sin( i+1 L ) */
-    cc[k][i] = cv;
+    sc->ss[k][i][l] = sv;		/* sin( i+1 L ) */
+    sc->cc[k][i][l] = cv;
+  }
+  /* LR has a term in 5*MP, but only 4 multiples of MP are computed;
+   * that term has always been read as zero from the static table */
+  for( ; i<6; i++ ) {
+    sc->ss[k][i][l] = 0;
+    sc->cc[k][i][l] = 0;
   }
 }
 
@@ -1246,8 +1373,10 @@ return( lx );
 }
 
 
-static void mean_elements()
+static void mean_elements(struct moon_args *ma)
 {
+double T = ma->T, T2 = ma->T2;
+double M, NF, MP, D, LP;
 double fracT = fmod(T, 1);
 /* Mean anomaly of sun = l' (J. Laskar) */
 /*M =  mods3600(129596581.038354 * T +  1287104.76154);*/
@@ -1285,4 +1414,9 @@ LP += ((z[11]*T + z[10])*T + z[9])*T2;
  * cos 2D 43.6
  * cos F  11.2 (latitude term)
  */
+ma->LP = LP;
+ma->M = M;
+ma->MP = MP;
+ma->D = D;
+ma->NF = NF;
 }
@@ -104,7 +104,14 @@ static struct plantbl *planets[] =
 static double FAR ss[9][24];
 static double FAR cc[9][24];
 
+/* Same tables for swi_moshplan2_batch(), with the instants of a batch
+ * innermost, so that the loops over them can use vector instructions.
+ */
+static double FAR ssb[9][24][MOSH_NBATCH];
+static double FAR ccb[9][24][MOSH_NBATCH];
+
 static void sscc (int k, double arg, int n);
+static void sscc_batch (int k, double *arg, int n, int nj);
 
 int swi_moshplan2 (double J, int iplm, double *pobj)
 {
@@ -238,6 +245,187 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
   return OK;
 }
 
+/* Like swi_moshplan2(), but for nj <= MOSH_NBATCH instants J[] at once.
+ * The table of terms is walked only once, and each term is evaluated 
+ * for all instants, with the instants innermost. pobj[] gets 3 doubles 
+ * for each instant.
+ * Every instant goes through the same operations in the same order as 
+ * in swi_moshplan2(), so the results are identical to it, unless the 
+ * compiler contracts multiplications and additions differently in the 
+ * two (e.g. with -ffp-contract=fast and FMA instructions), in which 
+ * case they differ by a few units in the last place.
+ */
+int swi_moshplan2_batch (double *J, int nj, int iplm, double *pobj)
+{
+  int i, j, k, l, m, k1, ip, np, nt;
+  signed char FAR *p;
+  double FAR *pl, *pb, *pr;
+  double sv[MOSH_NBATCH], cv[MOSH_NBATCH], *ps, *pc;
+  double T[MOSH_NBATCH], t, cl, sla, cb, sbe, cr, sra;
+  double sl[MOSH_NBATCH], sb[MOSH_NBATCH], sr[MOSH_NBATCH];
+  struct plantbl *plan = planets[iplm];
+
+  if (nj > MOSH_NBATCH)
+    return ERR;
+  for (l = 0; l < nj; l++)
+    T[l] = (J[l] - J2000) / TIMESCALE;
+  /* Calculate sin( i*MM ), etc. for needed multiple angles.  */
+  for (i = 0; i < 9; i++)
+    {
+      if ((j = plan->max_harmonic[i]) > 0)
+	{
+	  for (l = 0; l < nj; l++)
+	    sr[l] = (mods3600 (freqs[i] * T[l]) + phases[i]) * STR;
+	  sscc_batch (i, sr, j, nj);
+	}
+    }
+
+  /* Point to start of table of arguments. */
+  p = plan->arg_tbl;
+  /* Point to tabulated cosine and sine amplitudes.  */
+  pl = plan->lon_tbl;
+  pb = plan->lat_tbl;
+  pr = plan->rad_tbl;
+  for (l = 0; l < nj; l++)
+    sl[l] = sb[l] = sr[l] = 0.0;
+
+  for (;;)
+    {
+      /* argument of sine and cosine */
+      /* Number of periodic arguments. */
+      np = *p++;
+      if (np < 0)
+	break;
+      if (np == 0)
+	{			/* It is a polynomial term.  */
+	  nt = *p++;
+	  for (l = 0; l < nj; l++)
+	    {
+	      /* Longitude polynomial. */
+	      cl = pl[0];
+	      for (ip = 0; ip < nt; ip++)
+		cl = cl * T[l] + pl[ip+1];
+	      sl[l] += mods3600 (cl);
+	      /* Latitude polynomial. */
+	      cb = pb[0];
+	      for (ip = 0; ip < nt; ip++)
+		cb = cb * T[l] + pb[ip+1];
+	      sb[l] += cb;
+	      /* Radius polynomial. */
+	      cr = pr[0];
+	      for (ip = 0; ip < nt; ip++)
+		cr = cr * T[l] + pr[ip+1];
+	      sr[l] += cr;
+	    }
+	  pl += nt + 1;
+	  pb += nt + 1;
+	  pr += nt + 1;
+	  continue;
+	}
+      k1 = 0;
+      for (l = 0; l < nj; l++)
+	cv[l] = sv[l] = 0.0;
+      for (ip = 0; ip < np; ip++)
+	{
+	  /* What harmonic.  */
+	  j = *p++;
+	  /* Which planet.  */
+	  m = *p++ - 1;
+	  if (j)
+	    {
+	      k = j;
+	      if (j < 0)
+		k = -k;
+	      k -= 1;
+	      ps = ssb[m][k];	/* sin(k*angle) */
+	      pc = ccb[m][k];
+	      if (k1 == 0)
+		{		/* set first angle */
+		  for (l = 0; l < nj; l++)
+		    {
+		      sv[l] = j < 0 ? -ps[l] : ps[l];
+		      cv[l] = pc[l];
+		    }
+		  k1 = 1;
+		}
+	      else if (j < 0)
+		{		/* combine angles */
+		  for (l = 0; l < nj; l++)
+		    {
+		      t = -ps[l] * cv[l] + pc[l] * sv[l];
+		      cv[l] = pc[l] * cv[l] - -ps[l] * sv[l];
+		      sv[l] = t;
+		    }
+		}
+	      else
+		{
+		  for (l = 0; l < nj; l++)
+		    {
+		      t = ps[l] * cv[l] + pc[l] * sv[l];
+		      cv[l] = pc[l] * cv[l] - ps[l] * sv[l];
+		      sv[l] = t;
+		    }
+		}
+	    }
+	}
+      /* Highest power of T.  */
+      nt = *p++;
+      if (nt == 0)
+	{			/* constant amplitudes, the common case */
+	  for (l = 0; l < nj; l++)
+	    {
+	      sl[l] += pl[0] * cv[l] + pl[1] * sv[l];
+	      sb[l] += pb[0] * cv[l] + pb[1] * sv[l];
+	      sr[l] += pr[0] * cv[l] + pr[1] * sv[l];
+	    }
+	  pl += 2;
+	  pb += 2;
+	  pr += 2;
+	  continue;
+	}
+      for (l = 0; l < nj; l++)
+	{
+	  /* Longitude. */
+	  cl = pl[0];
+	  sla = pl[1];
+	  for (ip = 0; ip < nt; ip++)
+	    {
+	      cl = cl * T[l] + pl[2*ip+2];
+	      sla = sla * T[l] + pl[2*ip+3];
+	    }
+	  sl[l] += cl * cv[l] + sla * sv[l];
+	  /* Latitiude. */
+	  cb = pb[0];
+	  sbe = pb[1];
+	  for (ip = 0; ip < nt; ip++)
+	    {
+	      cb = cb * T[l] + pb[2*ip+2];
+	      sbe = sbe * T[l] + pb[2*ip+3];
+	    }
+	  sb[l] += cb * cv[l] + sbe * sv[l];
+	  /* Radius. */
+	  cr = pr[0];
+	  sra = pr[1];
+	  for (ip = 0; ip < nt; ip++)
+	    {
+	      cr = cr * T[l] + pr[2*ip+2];
+	      sra = sra * T[l] + pr[2*ip+3];
+	    }
+	  sr[l] += cr * cv[l] + sra * sv[l];
+	}
+      pl += 2 * nt + 2;
+      pb += 2 * nt + 2;
+      pr += 2 * nt + 2;
+    }
+  for (l = 0; l < nj; l++)
+    {
+      pobj[3*l] = STR * sl[l];
+      pobj[3*l+1] = STR * sb[l];
+      pobj[3*l+2] = STR * plan->distance * sr[l] + plan->distance;
+    }
+  return OK;
+}
+
 /* Moshier ephemeris.
  * computes heliocentric cartesian equatorial coordinates of
  * equinox 2000
@@ -255,6 +443,9 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
   double dx[3], x2[3], xxe[6], xxp[6];
   double *xp, *xe;
   double dt; 
+#ifndef NO_MOSH_BATCH
+  double tb[2], xb[6];
+#endif
   char s[AS_MAXCH];
   int iplm = pnoint2msh[ipli];
   struct plan_data *pdp = &swed.pldat[ipli];
@@ -287,7 +478,18 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
       xe = pedp->x;
     } else {
       /* emb */
+#ifndef NO_MOSH_BATCH
+      /* at tjd and, for speed, at tjd - PLAN_SPEED_INTV in one pass */
+      tb[0] = tjd;
+      tb[1] = tjd - PLAN_SPEED_INTV;
+      swi_moshplan2_batch(tb, 2, pnoint2msh[SEI_EMB], xb);
+      for (i = 0; i <= 2; i++) {
+	xe[i] = xb[i];
+	x2[i] = xb[i+3];
+      }
+#else
       swi_moshplan2(tjd, pnoint2msh[SEI_EMB], xe); /* emb hel. ecl. 2000 polar */ 
+#endif
       swi_polcart(xe, xe);			  /* to cartesian */
       swi_coortrf2(xe, xe, -seps2000, ceps2000);/* and equator 2000 */
       embofs_mosh(tjd, xe);		  /* emb -> earth */
@@ -297,7 +499,9 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
 	pedp->iephe = SEFLG_MOSEPH;
       }
       /* one more position for speed. */
+#ifdef NO_MOSH_BATCH
       swi_moshplan2(tjd - PLAN_SPEED_INTV, pnoint2msh[SEI_EMB], x2); 
+#endif
       swi_polcart(x2, x2);
       swi_coortrf2(x2, x2, -seps2000, ceps2000);
       embofs_mosh(tjd - PLAN_SPEED_INTV, x2);/**/
@@ -321,7 +525,17 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
     if (tjd == pdp->teval && pdp->iephe == SEFLG_MOSEPH) {
       xp = pdp->x;
     } else { 
+#ifndef NO_MOSH_BATCH
+      tb[0] = tjd;
+      tb[1] = tjd - PLAN_SPEED_INTV;
+      swi_moshplan2_batch(tb, 2, iplm, xb);
+      for (i = 0; i <= 2; i++) {
+	xp[i] = xb[i];
+	x2[i] = xb[i+3];
+      }
+#else
       swi_moshplan2(tjd, iplm, xp); 
+#endif
       swi_polcart(xp, xp);
       swi_coortrf2(xp, xp, -seps2000, ceps2000);
       if (do_save) {
@@ -338,7 +552,9 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
       dt = LIGHTTIME_AUNIT * sqrt(square_sum(dx));   
     #endif
       dt = PLAN_SPEED_INTV;
+#ifdef NO_MOSH_BATCH
       swi_moshplan2(tjd - dt, iplm, x2); 
+#endif
       swi_polcart(x2, x2);
       swi_coortrf2(x2, x2, -seps2000, ceps2000);
       for (i = 0; i <= 2; i++) 
@@ -383,6 +599,35 @@ static void sscc (int k, double arg, int n)
 }
 
 
+/* Same as sscc() for nj instants, into ssb[] and ccb[]
+ */
+static void sscc_batch (int k, double *arg, int n, int nj)
+{
+  double cu, su, cv, sv, s;
+  int i, l;
+
+  for (l = 0; l < nj; l++)
+    {
+      su = sin (arg[l]);
+      cu = cos (arg[l]);
+      ssb[k][0][l] = su;		/* sin(L) */
+      ccb[k][0][l] = cu;		/* cos(L) */
+      sv = 2.0 * su * cu;
+      cv = cu * cu - su * su;
+      ssb[k][1][l] = sv;		/* sin(2L) */
+      ccb[k][1][l] = cv;
+      for (i = 2; i < n; i++)
+	{
+	  s = su * cv + cu * sv;
+	  cv = cu * cv - su * sv;
+	  sv = s;
+	  ssb[k][i][l] = sv;		/* sin( i+1 L ) */
+	  ccb[k][i][l] = cv;
+	}
+    }
+}
+
+
 /* Adjust position from Earth-Moon barycenter to Earth
  *
  * J = Julian day number
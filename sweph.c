@@ -59,6 +59,9 @@
 #include "swephexp.h"
 #include "sweph.h"
 #include "swephlib.h"
+#ifdef SWI_MMAP
+# include <sys/mman.h>
+#endif
 
 #define IS_PLANET 		0
 #define IS_MOON			1
@@ -74,7 +77,72 @@ struct swe_data FAR swed = {SE_EPHE_PATH, SE_FNAME_DFT};
 
 struct meff_ele {double r,m;};
 
-static FILE *fixfp;	/* fixed stars */
+/* fixed stars: the star file is read only once into this table,
+ * which is kept until swe_close(), i.e. until the ephemeris path changes */
+struct fixstar_data {
+  char star[SE_MAX_STNAME * 2 + 1];	/* "trad_name,nomeclat_name" */
+  char tname[SE_MAX_STNAME + 1];	/* trad. name, lower case, for search */
+  char nname[SE_MAX_STNAME + 1];	/* line from first comma, for search */
+  int fline;			/* line number in star file */
+  int ncut;			/* number of fields in line */
+  double epoch, parall, mag;
+  double x[6];			/* cartesian position and speed */
+};
+static struct fixstar_data *fixstars;
+static int nfixstars;
+static int *fixstar_tind;	/* fixstars[] sorted by traditional name */
+static int *fixstar_nind;	/* fixstars[] sorted by nomenclature name */
+static int fixstar_damaged = -1;	/* first line without comma */
+
+/* position cache: for each body, a Chebyshev series fitted over a time
+ * window to the ecliptic longitude, latitude, distance and their speeds,
+ * as returned by swe_calc(). Only used if swe_set_cheb_cache() has set
+ * a maximum error. The cache is cleared by swe_close(). 
+ * A fit costs about 2 * CHEB_NCOEF direct computations, so a window is
+ * only fitted if the body is asked for densely enough that at least 
+ * CHEB_MINHITS positions are expected to be taken from it. */
+#define CHEB_NCOEF	13
+#define CHEB_NBODY	(SE_NPLANETS + SE_NFICT_ELEM)
+#define CHEB_MINSPAN	(1.0 / 64)	/* days */
+#define CHEB_MINELONG	3.0		/* degrees from sun, see cheb_near_sun() */
+#define CHEB_MINHITS	64
+struct cheb_seg {
+  double tstart, tspan;		/* window of segment, tspan 0 if none */
+  double span;			/* window length that fits well enough */
+  double tlast;			/* time the body was last asked for */
+  double dt;			/* average time between requests, 0 if none */
+  AS_BOOL fitted;		/* FALSE if no fit found for the window */
+  long iflag;			/* flags the segment was fitted for */
+  long iflgret;			/* flags returned by swe_calc() for them */
+  double coef[6][CHEB_NCOEF];
+};
+static struct cheb_seg cheb[CHEB_NBODY];
+static double cheb_maxerr = 0;	/* degrees, 0 if cache is off */
+static AS_BOOL cheb_fitting = FALSE;
+static long cheb_nhit = 0, cheb_nfit = 0;
+
+/* decoded segments kept per planet, see struct seg_cache */
+static int segc_n = SEI_NSEGCACHE_DFT;
+static long segc_luse = 0;
+static long segc_nhit = 0, segc_nmiss = 0;
+
+/* asteroid files kept open, see struct ast_file */
+static long astf_luse = 0;
+
+/* osculating node and apogee of recently computed dates. both are
+ * computed together from the same lunar positions by lunar_osc_elem(),
+ * so one entry serves either. entries are reused round robin. */
+#define OSC_NCACHE	8
+struct osc_cache {
+  double teval;			/* jd, 0 if unused */
+  long flgreq;			/* flags asked for, see lunar_osc_elem() */
+  long iflag;			/* flags actually used */
+  long iephe;
+  double xnode[6], xapog[6];	/* as swed.nddat[].x */
+};
+static struct osc_cache oscc[OSC_NCACHE];
+static int oscc_next = 0;
+static long oscc_nhit = 0, oscc_ncalc = 0, oscc_nshare = 0;
 
 static int FAR pnoint2jpl[]   = PNOINT2JPL;
 
@@ -82,6 +150,12 @@ static int pnoext2int[] = {SEI_SUN, SEI_MOON, SEI_MERCURY, SEI_VENUS, SEI_MARS,
 
 static AS_BOOL ephe_path_is_set = FALSE;
 
+static void close_eph_file(struct file_data *fdp);
+static AS_BOOL get_cached_segment(double tjd, struct plan_data *pdp);
+static void put_cached_segment(struct plan_data *pdp);
+static void free_seg_cache(struct plan_data *pdp);
+static void free_ast_file(struct file_data *fdp, struct plan_data *pdp);
+static void get_ast_file(int ipli);
 static int do_fread(void *targ, int size, int count, int corrsize, 
 		    FILE *fp, long fpos, int freord, int fendian, int ifno, 
 		    char *serr);
@@ -125,6 +199,13 @@ static void calc_speed(double *x0, double *x1, double *x2, double dt);
 static long plaus_iflag(long iflag);
 static int get_observer(double tjd, long iflag, 
 	double *xearth, AS_BOOL do_save, double *xobs, char *serr);
+static int load_fixstars(char *serr);
+static void free_fixstars(void);
+static int search_fixstar(char *sstar, size_t cmplen, AS_BOOL isnomclat);
+static long cheb_calc(double tjd, int ipl, long iflag, double *xx, char *serr);
+static int cheb_fit(struct cheb_seg *cs, int ipl, long iflag, char *serr);
+static AS_BOOL cheb_near_sun(struct cheb_seg *cs, int ipl, long iflag, 
+			     char *serr);
 
 #ifdef TRACE
 static void trace_swe_calc(int param, double tjd, int ipl, long iflag, double *xx, char *serr);
@@ -151,6 +232,7 @@ long FAR PASCAL_CONV swe_calc(double tjd, int ipl, long iflag,
   int i, j;
   long iflgcoor = SEFLG_EQUATORIAL | SEFLG_XYZ | SEFLG_RADIANS;
   long iflgsave = iflag;
+  long iflgcheb;
   long epheflag;
   static long epheflag_sv = 0;
   struct save_positions *sd;
@@ -219,21 +301,32 @@ long FAR PASCAL_CONV swe_calc(double tjd, int ipl, long iflag,
   if (ipl < SE_NPLANETS && ipl >= SE_SUN)
     sd = &swed.savedat[ipl];
   else
-    /* other bodies, e.g. asteroids called with ipl = SE_AST_OFFSET + MPC# */
-    sd = &swed.savedat[SE_NPLANETS];
+    /* other bodies, e.g. asteroids called with ipl = SE_AST_OFFSET + MPC#,
+     * have save areas hashed by body number */
+    sd = &swed.savedat[SE_NPLANETS + ((unsigned int) ipl & (SEI_NASTSAVE - 1))];
   /* 
    * if position is available in save area, it is returned.
    * this is the case, if tjd = tsave and iflag = iflgsave.
    * coordinate flags can be neglected, because save area 
    * provides all coordinate types.
-   * if ipl > SE_AST(EROID)_OFFSET, ipl must be checked, 
-   * because all asteroids called by MPC number share the same
-   * save area.
+   * if ipl >= SE_NPLANETS, ipl must be checked, 
+   * because several bodies may share the same save area.
    */ 
   if (sd->tsave == tjd && tjd != 0 && ipl == sd->ipl) {
     if ((sd->iflgsave & ~iflgcoor) == (iflag & ~iflgcoor)) 
       goto end_swe_calc;
   }
+  /*
+   * if the position cache is on, the position may be evaluated from
+   * a fitted Chebyshev segment. if not, it is computed as usual.
+   */
+  if (cheb_maxerr > 0 && !cheb_fitting) {
+    if ((iflgcheb = cheb_calc(tjd, ipl, iflag, xx, serr)) != ERR) {
+      if ((iflgsave & SEFLG_EPHMASK) == 0)
+	iflgcheb = iflgcheb & ~SEFLG_DEFAULTEPH;
+      return iflgcheb;
+    }
+  }
   /* 
    * otherwise, new position must be computed 
    */
@@ -326,6 +419,202 @@ return_error:
   return ERR; 
 }
 
+/* sets the maximum error of positions served from the position
+ * cache, in arc seconds. 0 turns the cache off. */
+void FAR PASCAL_CONV swe_set_cheb_cache(double maxerr)
+{
+  maxerr /= 3600.0;
+  if (maxerr == cheb_maxerr)
+    return;
+  cheb_maxerr = maxerr;
+  memset((void *) cheb, 0, sizeof(cheb));
+}
+
+void FAR PASCAL_CONV swe_get_cheb_stats(long *nhit, long *nfit)
+{
+  *nhit = cheb_nhit;
+  *nfit = cheb_nfit;
+}
+
+/* evaluates the position of a body from the position cache, fitting
+ * a new segment if none covers tjd.
+ * returns the flags swe_calc() would return, or ERR if the position
+ * has to be computed directly, e.g. because the flags ask for other
+ * coordinates than ecliptic polar ones, or because no segment fits
+ * the body well enough.
+ */
+static long cheb_calc(double tjd, int ipl, long iflag, double *xx, char *serr)
+{
+  int i;
+  double t, span;
+  struct cheb_seg *cs;
+  long iflgsave = iflag;
+  if (iflag & (SEFLG_SPEED3 | SEFLG_EQUATORIAL | SEFLG_XYZ | SEFLG_RADIANS 
+	       | SEFLG_TOPOCTR))
+    return ERR;
+  if (ipl >= SE_SUN && ipl < SE_NPLANETS)
+    cs = &cheb[ipl];
+  else if (ipl >= SE_FICT_OFFSET && ipl < SE_FICT_OFFSET + SE_NFICT_ELEM)
+    cs = &cheb[SE_NPLANETS + ipl - SE_FICT_OFFSET];
+  else
+    return ERR;
+  iflag |= SEFLG_SPEED;
+  /* keep track of how far apart the requests for the body are. 
+   * repeated requests for the same instant are left out, as
+   * swecalc() already serves them from its own saved position */
+  t = fabs(tjd - cs->tlast);
+  if (cs->tlast != 0 && t > 0)
+    cs->dt = (cs->dt == 0 ? t : (cs->dt * 3 + t) / 4);
+  cs->tlast = tjd;
+  if (cs->tspan == 0 || cs->iflag != iflag 
+      || tjd < cs->tstart || tjd > cs->tstart + cs->tspan) {
+    cs->iflag = iflag;
+    switch(ipl) {
+      case SE_MOON:
+      case SE_TRUE_NODE:
+      case SE_OSCU_APOG:
+	span = 2;
+	break;
+      case SE_SUN:
+      case SE_MERCURY:
+      case SE_VENUS:
+	span = 16;
+	break;
+      default:
+	span = 32;
+	break;
+    }
+    /* a window that had to be shortened, e.g. because of light 
+     * deflection near a conjunction with the sun, grows back 
+     * in the following windows */
+    if (cs->span == 0 || cs->span * 2 > span)
+      cs->span = span;
+    else
+      cs->span *= 2;
+    /* too few positions would be taken from the window to pay for
+     * fitting it, so compute them directly until requests get denser */
+    if (cs->dt == 0 || cs->span < cs->dt * CHEB_MINHITS) {
+      cs->tspan = 0;
+      return ERR;
+    }
+    /* windows are aligned to multiples of their length, so that 
+     * neighbouring instants share them. if no fit is found even for
+     * the shortest window, the window is remembered as unfitted, so
+     * that positions in it are computed directly without trying again */
+    for (;;) {
+      cs->tstart = floor(tjd / cs->span) * cs->span;
+      cs->tspan = cs->span;
+      if (cheb_near_sun(cs, ipl, iflag, serr)) {
+	cs->fitted = FALSE;
+	if (cs->span / 2 < 1 || cs->span / 2 < cs->dt * CHEB_MINHITS)
+	  break;
+      } else {
+	if ((cs->fitted = (cheb_fit(cs, ipl, iflag, serr) == OK)))
+	  break;
+	if (cs->span / 2 < CHEB_MINSPAN 
+	    || cs->span / 2 < cs->dt * CHEB_MINHITS)
+	  break;
+      }
+      cs->span /= 2;
+    }
+  }
+  if (!cs->fitted)
+    return ERR;
+  t = (tjd - cs->tstart) / cs->tspan * 2 - 1;
+  for (i = 0; i < 6; i++)
+    xx[i] = swi_echeb(t, cs->coef[i], CHEB_NCOEF);
+  xx[0] = swe_degnorm(xx[0]);
+  if (!(iflgsave & SEFLG_SPEED)) 
+    for (i = 3; i < 6; i++)
+      xx[i] = 0;
+  cheb_nhit++;
+  return cs->iflgret;
+}
+
+/* light deflection by the sun changes too fast for a smooth fit when
+ * a planet passes close to the sun. returns TRUE if the planet comes
+ * within CHEB_MINELONG degrees of the sun during the window of the
+ * segment, in which case a window of at least one day is left 
+ * unfitted.
+ */
+static AS_BOOL cheb_near_sun(struct cheb_seg *cs, int ipl, long iflag, 
+			     char *serr)
+{
+  int i;
+  double x[6], xs[6], e[2];
+  if (ipl == SE_SUN || ipl == SE_MOON || ipl == SE_EARTH
+      || (ipl >= SE_MEAN_NODE && ipl <= SE_OSCU_APOG)
+      || (iflag & (SEFLG_HELCTR | SEFLG_BARYCTR | SEFLG_NOGDEFL)))
+    return FALSE;
+  cheb_fitting = TRUE;
+  for (i = 0; i < 2; i++) {
+    if (swe_calc(cs->tstart + i * cs->tspan, ipl, iflag, x, serr) == ERR
+	|| swe_calc(cs->tstart + i * cs->tspan, SE_SUN, iflag, xs, serr) 
+	   == ERR) {
+      cheb_fitting = FALSE;
+      return FALSE;
+    }
+    e[i] = swe_difdeg2n(x[0], xs[0]);
+  }
+  cheb_fitting = FALSE;
+  if (fabs(e[0]) < CHEB_MINELONG || fabs(e[1]) < CHEB_MINELONG)
+    return TRUE;
+  /* conjunction within the window */
+  return (e[0] < 0) != (e[1] < 0) && fabs(e[0]) < 90 && fabs(e[1]) < 90;
+}
+
+/* fits a Chebyshev segment for a body over the window of the
+ * segment, by interpolating positions at the Chebyshev nodes.
+ * The fit is checked halfway between some of the nodes; returns
+ * OK if it is within the maximum error there, otherwise ERR. 
+ */
+static int cheb_fit(struct cheb_seg *cs, int ipl, long iflag, char *serr)
+{
+  int i, j, k;
+  long iflgret = 0;
+  double f[CHEB_NCOEF][6], xk[CHEB_NCOEF], x[6], t, d;
+  cheb_fitting = TRUE;
+  for (k = 0; k < CHEB_NCOEF; k++) {
+    xk[k] = cos(PI * (k + 0.5) / CHEB_NCOEF);
+    t = cs->tstart + cs->tspan * (xk[k] + 1) / 2;
+    if ((iflgret = swe_calc(t, ipl, iflag, f[k], serr)) == ERR) {
+      cheb_fitting = FALSE;
+      return ERR;
+    }
+    /* keep the longitude continuous across the window */
+    if (k > 0) 
+      f[k][0] = f[k-1][0] + swe_difdeg2n(f[k][0], f[k-1][0]);
+  }
+  for (i = 0; i < 6; i++) {
+    for (j = 0; j < CHEB_NCOEF; j++) {
+      d = 0;
+      for (k = 0; k < CHEB_NCOEF; k++)
+	d += f[k][i] * cos(PI * j * (k + 0.5) / CHEB_NCOEF);
+      cs->coef[i][j] = d * 2 / CHEB_NCOEF;
+    }
+  }
+  cheb_nfit++;
+  /* check the fit halfway between the nodes */
+  for (k = 0; k < CHEB_NCOEF - 1; k++) {
+    d = (xk[k] + xk[k+1]) / 2;
+    t = cs->tstart + cs->tspan * (d + 1) / 2;
+    if (swe_calc(t, ipl, iflag, x, serr) == ERR) {
+      cheb_fitting = FALSE;
+      return ERR;
+    }
+    if (fabs(swe_difdeg2n(swi_echeb(d, cs->coef[0], CHEB_NCOEF), x[0])) 
+	  > cheb_maxerr
+	|| fabs(swi_echeb(d, cs->coef[1], CHEB_NCOEF) - x[1]) > cheb_maxerr
+	|| fabs(swi_echeb(d, cs->coef[3], CHEB_NCOEF) - x[3]) > cheb_maxerr) {
+      cheb_fitting = FALSE;
+      return ERR;
+    }
+  }
+  cheb_fitting = FALSE;
+  cs->iflgret = iflgret;
+  return OK;
+}
+
 static long swecalc(double tjd, int ipl, long iflag, double *x, char *serr) 
 {
   int i;
@@ -867,8 +1156,7 @@ void FAR PASCAL_CONV swe_close(void)
   int i;
   /* close SWISSEPH files */
   for (i = 0; i < SEI_NEPHFILES; i ++) {
-    if (swed.fidat[i].fptr != NULL) 
-      fclose(swed.fidat[i].fptr);
+    close_eph_file(&swed.fidat[i]);
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   /* free planets data space */
@@ -876,11 +1164,16 @@ void FAR PASCAL_CONV swe_close(void)
     if (swed.pldat[i].segp != NULL) {
       free((void *) swed.pldat[i].segp);
     }
+    free_seg_cache(&swed.pldat[i]);
     if (swed.pldat[i].refep != NULL) {
       free((void *) swed.pldat[i].refep);
     }
     memset((void *) &swed.pldat[i], 0, sizeof(struct plan_data));
   }
+  /* close asteroid files kept open */
+  for (i = 0; i < SEI_NASTFILES; i++)
+    free_ast_file(&swed.astfdat[i].fd, &swed.astfdat[i].pd);
+  memset((void *) swed.astfdat, 0, sizeof(swed.astfdat));
   /* clear node data space */
   for (i = 0; i < SEI_NNODE_ETC; i++) {
     memset((void *) &swed.nddat[i], 0, sizeof(struct node_data));
@@ -895,11 +1188,11 @@ void FAR PASCAL_CONV swe_close(void)
   swi_close_jpl_file();
 #endif
   swed.jpl_file_is_open = FALSE;
-  /* close fixed stars */
-  if (fixfp != NULL) {
-    fclose(fixfp);
-    fixfp = NULL;
-  }
+  /* free fixed stars */
+  free_fixstars();
+  /* clear position cache */
+  memset((void *) cheb, 0, sizeof(cheb));
+  memset((void *) oscc, 0, sizeof(oscc));
 #ifdef TRACE
   swi_open_trace(NULL);
   if (swi_fp_trace_c != NULL) {
@@ -1653,19 +1946,23 @@ static int sweph(double tjd, int ipli, int ifno, long iflag, double *xsunb, AS_B
   /****************************** 
    * get correct ephemeris file * 
    ******************************/
+  /* if new asteroid, keep old file open and take the new one
+   * from the asteroid files kept open, if it is there */
+  if (ipl == SEI_ANYBODY && ipli != pdp->ibdy)
+    get_ast_file(ipli);
   if (fdp->fptr != NULL) {
     /* if tjd is beyond file range, close old file.
      * if new asteroid, close old file. */
     if (tjd < fdp->tfstart || tjd > fdp->tfend
       || (ipl == SEI_ANYBODY && ipli != pdp->ibdy)) { 	
-      fclose(fdp->fptr);
-      fdp->fptr = NULL;
+      close_eph_file(fdp);
       if (pdp->refep != NULL)
 	free((void *) pdp->refep);
       pdp->refep = NULL;
       if (pdp->segp != NULL)
 	free((void *) pdp->segp);
       pdp->segp = NULL;
+      free_seg_cache(pdp);
     }
   }
   /* if sweph file not open, find and open it */
@@ -1734,8 +2031,9 @@ again:
   /******************************
    * get planet's position      
    ******************************/
-  /* get new segment, if necessary */
-  if (pdp->segp == NULL || tjd < pdp->tseg0 || tjd > pdp->tseg1) {
+  /* get new segment, if necessary. it may have been decoded before */
+  if ((pdp->segp == NULL || tjd < pdp->tseg0 || tjd > pdp->tseg1)
+      && !get_cached_segment(tjd, pdp)) {
     retc = get_new_segment(tjd, ipl, ifno, serr);
     if (retc != OK)
       return(retc);
@@ -1745,6 +2043,7 @@ again:
       rot_back(ipl); /**/
     else
       pdp->neval = pdp->ncoe;
+    put_cached_segment(pdp);
   }
   /* evaluate chebyshew polynomial for tjd */
   t = (tjd - pdp->tseg0) / pdp->dseg;
@@ -3283,7 +3582,10 @@ static int get_new_segment(double tjd, int ipli, int ifno, char *serr)
   retc = do_fread((void *) &fpos, 3, 1, 4, fp, fpos, freord, fendian, ifno, serr);
   if (retc != OK)
     return (retc);
-  fseek(fp, fpos, SEEK_SET);
+  if (fdp->mptr != NULL)
+    fdp->mpos = fpos;
+  else
+    fseek(fp, fpos, SEEK_SET);
   /* clear space of chebyshew coefficients */
   if (pdp->segp == NULL)
     pdp->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8);
@@ -3647,6 +3949,7 @@ static int read_const(int ifno, char *serr)
 	  free((void *) pdp->segp);	/* array of coefficients of */
 	  pdp->segp = NULL;	/* ephemeris segment        */	
         }
+	free_seg_cache(pdp);
       }
       pdp->refep = (double *) malloc((size_t) pdp->ncoe * 2 * 8); 
       retc = do_fread((void *) pdp->refep, 8, 2*pdp->ncoe, 8, fp, SEI_CURR_FPOS, freord, fendian, ifno, serr); 
@@ -3654,6 +3957,20 @@ static int read_const(int ifno, char *serr)
 	return (retc);
     }/**/
   }
+#ifdef SWI_MMAP
+  /* the header has been read with stdio. map the whole file, so that 
+   * segments can be decoded from memory without further system calls, 
+   * and the pages are shared by all processes reading the file. 
+   * if mapping fails, the file is still read with stdio. */
+  fdp->mptr = (unsigned char *) mmap(NULL, (size_t) flen, PROT_READ, 
+				     MAP_SHARED, fileno(fp), 0);
+  if ((void *) fdp->mptr == MAP_FAILED) {
+    fdp->mptr = NULL;
+  } else {
+    fdp->mlen = flen;
+    fdp->mpos = 0;
+  }
+#endif
   return(OK);
 file_damage:
   if (serr != NULL && errmsglen < AS_MAXCH)
@@ -3684,9 +4001,31 @@ static int do_fread(void *trg, int size, int count, int corrsize, FILE *fp, long
 {
   int i, j, k; 
   int totsize;
-  unsigned char space[1000];
+  unsigned char space[1000], *src = space;
   unsigned char *targ = (unsigned char *) trg;
+  struct file_data *fdp = &swed.fidat[ifno];
   totsize = size * count;
+  /* if the file is mapped into memory, items are decoded directly 
+   * from the mapping */
+  if (fdp->mptr != NULL) {
+    if (fpos >= 0)
+      fdp->mpos = fpos;
+    if (fdp->mpos + totsize > fdp->mlen) {
+      if (serr != NULL) {
+	strcpy(serr, "Ephemeris file is damaged. ");
+	if (strlen(serr) + strlen(fdp->fnam) < AS_MAXCH - 1)
+	  sprintf(serr, "Ephemeris file %s is damaged.", fdp->fnam);
+      }
+      return(ERR);
+    }
+    src = fdp->mptr + fdp->mpos;
+    fdp->mpos += totsize;
+    if (!freord && size == corrsize) {
+      memcpy((void *) targ, (void *) src, (size_t) totsize);
+      return(OK);
+    }
+    goto reorder;
+  }
   if (fpos >= 0) 
     fseek(fp, fpos, SEEK_SET);
   /* if no byte reorder has to be done, and read size == return size */
@@ -3713,6 +4052,7 @@ static int do_fread(void *trg, int size, int count, int corrsize, FILE *fp, long
       fp = NULL;
       return(ERR);
     }
+reorder:
     if (size != corrsize) {
       memset((void *) targ, 0, (size_t) count * corrsize);
     }
@@ -3726,13 +4066,183 @@ static int do_fread(void *trg, int size, int count, int corrsize, FILE *fp, long
           if ((fendian == SEI_FILE_BIGENDIAN && !freord) ||
               (fendian == SEI_FILE_LITENDIAN &&  freord))
 	    k += corrsize - size;
-        targ[i*corrsize+k] = space[i*size+j];
+        targ[i*corrsize+k] = src[i*size+j];
       }
     }
   }
   return(OK);
 }
 
+/* SWISSEPH
+ * sets how many decoded segments are kept per planet, 
+ * 0 to keep only the current one
+ */
+void FAR PASCAL_CONV swe_set_seg_cache(int nseg)
+{
+  int i;
+  if (nseg < 0)
+    nseg = 0;
+  if (nseg > SEI_NSEGCACHE)
+    nseg = SEI_NSEGCACHE;
+  if (nseg == segc_n)
+    return;
+  segc_n = nseg;
+  for (i = 0; i < SEI_NPLANETS; i++)
+    free_seg_cache(&swed.pldat[i]);
+  for (i = 0; i < SEI_NASTFILES; i++)
+    free_seg_cache(&swed.astfdat[i].pd);
+}
+
+void FAR PASCAL_CONV swe_get_seg_stats(long *nhit, long *nmiss)
+{
+#ifndef NO_JPL
+  long nhitj, nreadj;
+  swi_get_jpl_stats(&nhitj, &nreadj);
+  *nhit = segc_nhit + nhitj;
+  *nmiss = segc_nmiss + nreadj;
+#else
+  *nhit = segc_nhit;
+  *nmiss = segc_nmiss;
+#endif
+}
+
+void FAR PASCAL_CONV swe_get_osc_stats(long *nhit, long *ncalc, long *nshare)
+{
+  *nhit = oscc_nhit;
+  *ncalc = oscc_ncalc;
+  *nshare = oscc_nshare;
+}
+
+/* SWISSEPH
+ * looks for a kept segment of a planet that covers tjd, and if there
+ * is one, makes it the current segment.
+ * returns FALSE if the segment has to be read from the file.
+ */
+static AS_BOOL get_cached_segment(double tjd, struct plan_data *pdp)
+{
+  int i;
+  struct seg_cache *sc;
+  for (i = 0; i < segc_n; i++) {
+    sc = &pdp->segc[i];
+    if (sc->segp == NULL || tjd < sc->tseg0 || tjd > sc->tseg1)
+      continue;
+    if (pdp->segp == NULL)
+      pdp->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8);
+    if (pdp->segp == NULL)
+      return FALSE;
+    memcpy((void *) pdp->segp, (void *) sc->segp, (size_t) pdp->ncoe * 3 * 8);
+    pdp->tseg0 = sc->tseg0;
+    pdp->tseg1 = sc->tseg1;
+    pdp->neval = sc->neval;
+    sc->luse = ++segc_luse;
+    segc_nhit++;
+    return TRUE;
+  }
+  segc_nmiss++;
+  return FALSE;
+}
+
+/* SWISSEPH
+ * keeps a copy of the current segment of a planet, in place of the 
+ * least recently used one
+ */
+static void put_cached_segment(struct plan_data *pdp)
+{
+  int i;
+  struct seg_cache *sc = NULL;
+  for (i = 0; i < segc_n; i++) {
+    if (sc == NULL || pdp->segc[i].luse < sc->luse)
+      sc = &pdp->segc[i];
+  }
+  if (sc == NULL)
+    return;
+  if (sc->segp == NULL)
+    sc->segp = (double *) malloc((size_t) pdp->ncoe * 3 * 8);
+  if (sc->segp == NULL)
+    return;
+  memcpy((void *) sc->segp, (void *) pdp->segp, (size_t) pdp->ncoe * 3 * 8);
+  sc->tseg0 = pdp->tseg0;
+  sc->tseg1 = pdp->tseg1;
+  sc->neval = pdp->neval;
+  sc->luse = ++segc_luse;
+}
+
+/* SWISSEPH
+ * frees the kept segments of a planet, e.g. if its file is closed
+ */
+static void free_seg_cache(struct plan_data *pdp)
+{
+  int i;
+  for (i = 0; i < SEI_NSEGCACHE; i++) {
+    if (pdp->segc[i].segp != NULL)
+      free((void *) pdp->segc[i].segp);
+  }
+  memset((void *) pdp->segc, 0, sizeof(pdp->segc));
+}
+
+/* SWISSEPH
+ * closes an asteroid file and frees the data read from it
+ */
+static void free_ast_file(struct file_data *fdp, struct plan_data *pdp)
+{
+  close_eph_file(fdp);
+  if (pdp->refep != NULL)
+    free((void *) pdp->refep);
+  if (pdp->segp != NULL)
+    free((void *) pdp->segp);
+  free_seg_cache(pdp);
+  memset((void *) fdp, 0, sizeof(struct file_data));
+  memset((void *) pdp, 0, sizeof(struct plan_data));
+}
+
+/* SWISSEPH
+ * makes asteroid ipli current in fidat[SEI_FILE_ANY_AST] and 
+ * pldat[SEI_ANYBODY], if its file is kept open. the current asteroid 
+ * is kept open in its place. if ipli is not kept open, the current
+ * asteroid takes the place of the least recently used one, which is
+ * closed, and the current file is left closed, to be opened by sweph().
+ */
+static void get_ast_file(int ipli)
+{
+  int i;
+  struct file_data *fdp = &swed.fidat[SEI_FILE_ANY_AST];
+  struct plan_data *pdp = &swed.pldat[SEI_ANYBODY];
+  struct ast_file *afp = &swed.astfdat[0], aftmp;
+  for (i = 0; i < SEI_NASTFILES; i++) {
+    if (swed.astfdat[i].fd.fptr != NULL && swed.astfdat[i].pd.ibdy == ipli)
+      break;
+    if (afp->fd.fptr != NULL && (swed.astfdat[i].fd.fptr == NULL
+      || swed.astfdat[i].luse < afp->luse))
+      afp = &swed.astfdat[i];
+  }
+  if (i < SEI_NASTFILES)
+    afp = &swed.astfdat[i];
+  else
+    free_ast_file(&afp->fd, &afp->pd);
+  aftmp.fd = *fdp;
+  aftmp.pd = *pdp;
+  *fdp = afp->fd;
+  *pdp = afp->pd;
+  afp->fd = aftmp.fd;
+  afp->pd = aftmp.pd;
+  afp->luse = ++astf_luse;
+}
+
+/* SWISSEPH
+ * closes an ephemeris file, and unmaps it if it is mapped into memory
+ */
+static void close_eph_file(struct file_data *fdp)
+{
+#ifdef SWI_MMAP
+  if (fdp->mptr != NULL)
+    munmap((void *) fdp->mptr, (size_t) fdp->mlen);
+#endif
+  fdp->mptr = NULL;
+  if (fdp->fptr != NULL)
+    fclose(fdp->fptr);
+  fdp->fptr = NULL;
+}
+
 /* SWISSEPH
  * adds reference orbit to chebyshew series (if SEI_FLG_ELLIPSE),
  * rotates series to mean equinox of J2000
@@ -3945,14 +4455,16 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
   long flg1, flg2;
   struct node_data *ndp, *ndnp, *ndap;
   struct epsilon *oe;
+  struct osc_cache *ocp;
   double speed_intv = NODE_CALC_INTV;	/* to silence gcc warning */
-  double a, b;
+  double a, b, tb[3];
   double xpos[3][6], xx[3][6], xxa[3][6], xnorm[6], r[6];
   double *xp;
   double rxy, rxyz, t, dt, fac, sgn;
   double sinnode, cosnode, sinincl, cosincl, sinu, cosu, sinE, cosE;
   double uu, ny, sema, ecce, Gmsm, c2, v2, pp;
   long speedf1, speedf2;
+  AS_BOOL moon_mosh;
   ndp = &swed.nddat[ipl];
   if (iflag & SEFLG_J2000)
     oe = &swed.oec2000;
@@ -3970,8 +4482,27 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
 	&& (!speedf2 || speedf1)) {
     ndp->xflgs = iflag;
     ndp->iephe = iflag & SEFLG_EPHMASK;
+    oscc_nhit++;
     return OK;
   }
+  /* or for this date in the cache of recent dates */
+  ndnp = &swed.nddat[SEI_TRUE_NODE];
+  ndap = &swed.nddat[SEI_OSCU_APOG];
+  for (i = 0; i < OSC_NCACHE; i++) {
+    ocp = &oscc[i];
+    if (tjd == ocp->teval && tjd != 0 && flg1 == ocp->flgreq) {
+      for (j = 0; j <= 5; j++) {
+	ndnp->x[j] = ocp->xnode[j];
+	ndap->x[j] = ocp->xapog[j];
+      }
+      ndnp->teval = ndap->teval = tjd;
+      ndnp->iephe = ndap->iephe = ocp->iephe;
+      iflag = ocp->iflag;
+      oscc_nhit++;
+      goto osc_return;
+    }
+  }
+  oscc_ncalc++;
   /* the geocentric position vector and the speed vector of the
    * moon make up the lunar orbital plane. the position vector 
    * of the node is along the intersection line of the orbital 
@@ -3999,7 +4530,10 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
   else if (iflag & SEFLG_JPLEPH)
     epheflag = SEFLG_JPLEPH;
   /* there may be a moon of wrong ephemeris in save area
-   * force new computation: */
+   * force new computation. a moshier moon of this date is 
+   * remembered, to be shared if the moshier moon is used below. */
+  moon_mosh = (tjd == swed.pldat[SEI_MOON].teval 
+	       && swed.pldat[SEI_MOON].iephe == SEFLG_MOSEPH);
   swed.pldat[SEI_MOON].teval = 0;
   if (iflag & SEFLG_SPEED) 
     istart = 0;
@@ -4107,6 +4641,23 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
       /* with moshier moon, we need a greater speed_intv, because here the
        * node and apogee oscillate wildly within small intervals */
       speed_intv = NODE_CALC_INTV_MOSH;
+      /* the two positions for the speed in one batch. the one
+       * at tjd is the moon of the chart itself, which is saved, 
+       * or taken from the save area if already computed. */
+      if (istart == 0) {
+	tb[0] = tjd - speed_intv;
+	tb[1] = tjd + speed_intv;
+	retc = swi_moshmoon_list(tb, 2, xpos[0], serr);
+	if (retc == ERR)
+	  return(retc);
+      }
+      if (moon_mosh && swed.pldat[SEI_MOON].iephe == SEFLG_MOSEPH) {
+	swed.pldat[SEI_MOON].teval = tjd;
+	oscc_nshare++;
+      }
+      retc = swi_moshmoon(tjd, DO_SAVE, xpos[2], serr);/**/
+      if (retc == ERR)
+	return(retc);
       for (i = istart; i <= 2; i++) {
 	if (i == 0)
 	  t = tjd - speed_intv;
@@ -4114,9 +4665,6 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
 	  t = tjd + speed_intv;
         else 
 	  t = tjd;
-	retc = swi_moshmoon(t, NO_SAVE, xpos[i], serr);/**/
-	if (retc == ERR)
-	  return(retc);
 #if 0
 	/* light-time-corrected moon for apparent node.
 	 * can be neglected with moshier */
@@ -4246,6 +4794,18 @@ static int lunar_osc_elem(double tjd, int ipl, long iflag, char *serr)
     else
       ndnp->x[i+3] = 0;
   }
+  /* keep both for this date */
+  ocp = &oscc[oscc_next];
+  oscc_next = (oscc_next + 1) % OSC_NCACHE;
+  ocp->teval = tjd;
+  ocp->flgreq = flg1;
+  ocp->iflag = iflag;
+  ocp->iephe = epheflag;
+  for (j = 0; j <= 5; j++) {
+    ocp->xnode[j] = ndnp->x[j];
+    ocp->xapog[j] = ndap->x[j];
+  }
+  osc_return:
   /**********************************************************************
    * precession and nutation have already been taken into account
    * because the computation is on the basis of lunar positions
@@ -4626,15 +5186,12 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
   AS_BOOL  isnomclat = FALSE;
   size_t cmplen;
   double x[6], xobs[6], *xpo = NULL;
-  char *cpos[20];
   char sstar[SE_MAX_STNAME + 1];
-  char fstar[SE_MAX_STNAME + 1];
-  char s[AS_MAXCH + 20], *sp, *sp2;	/* 20 byte for SE_STARFILE */
-  double ra_s, ra_pm, de_pm, ra, de, t, cosra, cosde, sinra, sinde;
-  double ra_h, ra_m, de_d, de_m, de_s;
-  double epoch, radv, parall, u;
-  int line = 0;
-  int fline = 0;
+  char *sp;
+  double t;
+  double epoch, parall, u;
+  int istar;
+  struct fixstar_data *fsp;
   struct plan_data *pedp = &swed.pldat[SEI_EARTH];
   struct plan_data *psdp = &swed.pldat[SEI_SUNBARY];
   struct epsilon *oe = &swed.oec2000;
@@ -4657,8 +5214,8 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
    * nutation                               * 
    ******************************************/
   check_nutation(tjd, iflag);
-  if (fixfp == NULL) {
-    if ((fixfp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE, swed.ephepath, serr)) == NULL) {
+  if (fixstars == NULL) {
+    if (load_fixstars(serr) != OK) {
       retc = ERR;
       goto return_err;
     }
@@ -4670,7 +5227,6 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
    * All other stars can be accessed by name.
    * Comment lines start with # and are ignored.
    ******************************************************/
-  rewind(fixfp);
   strncpy(sstar, star, SE_MAX_STNAME),
   sstar[SE_MAX_STNAME] = '\0';
   if (*sstar == ',') {
@@ -4692,121 +5248,42 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
     retc = ERR;
     goto return_err;
   }
-  while (fgets(s, AS_MAXCH, fixfp) != NULL) {
-    fline++;	
-    if (*s == '#') continue;
-    line++;
-    if (star_nr == line)
-      goto found;
-    else if (star_nr > 0)
-      continue;
-    if ((sp = strchr(s, ',')) == NULL) {
+  if (star_nr > 0) {
+    istar = star_nr <= nfixstars ? star_nr - 1 : -1;
+  } else {
+    istar = search_fixstar(sstar, cmplen, isnomclat);
+    /* a line without comma before the star stops the search */
+    if (fixstar_damaged >= 0 && (istar < 0 || fixstar_damaged < istar)) {
       if (serr != NULL)
-	sprintf(serr, "star file %s damaged at line %d", SE_STARFILE, fline);
+	sprintf(serr, "star file %s damaged at line %d", SE_STARFILE,
+	  fixstars[fixstar_damaged].fline);
       retc = ERR;
       goto return_err;
     } 
-    if (isnomclat) {
-      if (strncmp(sp, sstar, cmplen) == 0)
-        goto found;
-      else
-        continue;
-    }
-    *sp = '\0';	/* cut off first field */
-    strncpy(fstar, s, SE_MAX_STNAME);
-    *sp = ',';
-    fstar[SE_MAX_STNAME] = '\0';	/* force termination */
-    swi_right_trim(fstar);
-    i = strlen(fstar);
-    if (i < (int) cmplen)
-      continue;
-    for (sp2 = fstar; *sp2 != '\0'; sp2++) {
-      *sp2 = tolower((int) *sp2);
-    }
-    if (strncmp(fstar, sstar, cmplen) == 0) 
-      goto found;
-  }
-  if (serr != NULL && strlen(star) < AS_MAXCH - 20) 
-    sprintf(serr, "star %s not found", star);
-  retc = ERR;
-  goto return_err;
-  found:
-  i = swi_cutstr(s, ",", cpos, 20);
-  swi_right_trim(cpos[0]);
-  swi_right_trim(cpos[1]);
-  if (i < 14) {
-    sprintf(serr, "data of star '%s,%s' incomplete", cpos[0], cpos[1]);
+  }
+  if (istar < 0) {
+    if (serr != NULL && strlen(star) < AS_MAXCH - 20) 
+      sprintf(serr, "star %s not found", star);
     retc = ERR;
     goto return_err;
   }
-  epoch = atof(cpos[2]);
-  ra_h = atof(cpos[3]);
-  ra_m = atof(cpos[4]);
-  ra_s = atof(cpos[5]);
-  de_d = atof(cpos[6]);
-  de_m = atof(cpos[7]);
-  de_s = atof(cpos[8]);
-  ra_pm = atof(cpos[9]);
-  de_pm = atof(cpos[10]);
-  radv = atof(cpos[11]);
-  parall = atof(cpos[12]);
+  fsp = &fixstars[istar];
+  if (fsp->ncut < 14) {
+    if (serr != NULL)
+      sprintf(serr, "data of star '%s' incomplete", fsp->star);
+    retc = ERR;
+    goto return_err;
+  }
+  epoch = fsp->epoch;
+  parall = fsp->parall;
   /* return trad. name, nomeclature name */
-  if (strlen(cpos[0]) > SE_MAX_STNAME)
-    cpos[0][SE_MAX_STNAME] = '\0';
-  if (strlen(cpos[1]) > SE_MAX_STNAME-1)
-    cpos[1][SE_MAX_STNAME-1] = '\0';
-  sprintf(star, "%s,%s", cpos[0], cpos[1]);
+  strcpy(star, fsp->star);
   /****************************************
-   * position and speed (equinox)
+   * position and speed (equinox),
+   * FK5, computed by load_fixstars()
    ****************************************/
-  /* ra and de in degrees */
-  ra = (ra_s / 3600.0 + ra_m / 60.0 + ra_h) * 15.0;
-  if (de_d >= 0)
-    de = de_s / 3600.0 + de_m / 60.0 + de_d;
-  else
-    de = -de_s / 3600.0 - de_m / 60.0 + de_d;
-  /* speed in ra and de, degrees per century */
-  ra_pm = ra_pm * 15 / 3600.0;
-  de_pm = de_pm / 3600.0;
-  /* parallax, degrees */
-  if (parall > 1)
-    parall = (1 / parall / 3600);
-  else
-    parall /= 3600;
-  /* radial velocity in AU per century */
-  radv *= KM_S_TO_AU_CTY;
-  /* radians */
-  ra *= DEGTORAD;
-  de *= DEGTORAD;
-  ra_pm *= DEGTORAD;
-  de_pm *= DEGTORAD;
-  parall *= DEGTORAD;
-  x[0] = ra;
-  x[1] = de;
-  x[2] = 1;	/* -> unit vector */
-  /* cartesian */
-  swi_polcart(x, x);
-  /*space motion vector */
-  cosra = cos(ra);
-  cosde = cos(de);
-  sinra = sin(ra);
-  sinde = sin(de);
-  x[3] = -ra_pm * cosde * sinra - de_pm * sinde * cosra
-			+ radv * parall * cosde * cosra;
-  x[4] = ra_pm * cosde * cosra - de_pm * sinde * sinra
-			+ radv * parall * cosde * sinra;
-  x[5] = de_pm * cosde + radv * parall * sinde;
-  x[3] /= 36525;
-  x[4] /= 36525;
-  x[5] /= 36525;
-  /******************************************
-   * FK5
-   ******************************************/
-  if (epoch == 1950) {
-    swi_FK4_FK5(x, B1950);
-    swi_precess(x, B1950, J_TO_J2000);
-    swi_precess(x+3, B1950, J_TO_J2000);
-  } 
+  for (i = 0; i <= 5; i++)
+    x[i] = fsp->x[i];
 #if 0
   if (((iflag & SEFLG_NOGDEFL) == 0 || (iflag & SEFLG_NOABERR) == 0)
     && (iflag & SEFLG_HELCTR) == 0
@@ -4940,7 +5417,7 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
   }
   for (i = 0; i <= 5; i++)
     xx[i] = x[i];
-    xx[2] = atof(cpos[13]);
+  xx[2] = fsp->mag;
   /* if no ephemeris has been specified, do not return chosen ephemeris */
   if ((iflgsave & SEFLG_EPHMASK) == 0)
     iflag = iflag & ~SEFLG_DEFAULTEPH;
@@ -4957,6 +5434,223 @@ long FAR PASCAL_CONV swe_fixstar(char *star, double tjd, long iflag,
   return retc;
 }
 
+/**********************************************************
+ * read the whole star file into the table fixstars[]
+ * The data of each star are converted to a cartesian
+ * position and speed vector for the epoch of the star file
+ * (FK5), i.e. everything that does not depend on tjd is
+ * done here once, not on each call of swe_fixstar().
+ * Star numbers given to swe_fixstar() are indices into
+ * the table, names are looked up in the two sorted index
+ * arrays fixstar_tind[] and fixstar_nind[].
+**********************************************************/
+static int fixstar_tcmp(const void *p1, const void *p2)
+{
+  int i1 = *(int *) p1, i2 = *(int *) p2;
+  int c = strcmp(fixstars[i1].tname, fixstars[i2].tname);
+  return c != 0 ? c : i1 - i2;
+}
+
+static int fixstar_ncmp(const void *p1, const void *p2)
+{
+  int i1 = *(int *) p1, i2 = *(int *) p2;
+  int c = strcmp(fixstars[i1].nname, fixstars[i2].nname);
+  return c != 0 ? c : i1 - i2;
+}
+
+static int load_fixstars(char *serr)
+{
+  int i, n, nalloc = 0;
+  int fline = 0;
+  FILE *fp;
+  struct fixstar_data *fsp, *fsp2;
+  char *cpos[20];
+  char s[AS_MAXCH + 20], *sp, *sp2;	/* 20 byte for SE_STARFILE */
+  double ra_s, ra_pm, de_pm, ra, de, cosra, cosde, sinra, sinde;
+  double ra_h, ra_m, de_d, de_m, de_s;
+  double radv, parall;
+  double *x;
+  if ((fp = swi_fopen(SEI_FILE_FIXSTAR, SE_STARFILE, swed.ephepath, serr)) == NULL)
+    return ERR;
+  free_fixstars();
+  while (fgets(s, AS_MAXCH, fp) != NULL) {
+    fline++;	
+    if (*s == '#') continue;
+    if (nfixstars >= nalloc) {
+      nalloc = nalloc == 0 ? 256 : nalloc * 2;
+      fsp2 = (struct fixstar_data *) realloc((void *) fixstars, 
+	nalloc * sizeof(struct fixstar_data));
+      if (fsp2 == NULL) {
+	if (serr != NULL)
+	  sprintf(serr, "error in malloc() with star file %s", SE_STARFILE);
+	fclose(fp);
+	free_fixstars();
+	return ERR;
+      }
+      fixstars = fsp2;
+    }
+    fsp = &fixstars[nfixstars];
+    memset((void *) fsp, 0, sizeof(struct fixstar_data));
+    fsp->fline = fline;
+    if ((sp = strchr(s, ',')) == NULL) {
+      if (fixstar_damaged < 0)
+	fixstar_damaged = nfixstars;
+      fsp->ncut = 1;
+      nfixstars++;
+      continue;
+    } 
+    /* search keys */
+    strncpy(fsp->nname, sp, SE_MAX_STNAME);
+    fsp->nname[SE_MAX_STNAME] = '\0';
+    *sp = '\0';	/* cut off first field */
+    strncpy(fsp->tname, s, SE_MAX_STNAME);
+    *sp = ',';
+    fsp->tname[SE_MAX_STNAME] = '\0';	/* force termination */
+    swi_right_trim(fsp->tname);
+    for (sp2 = fsp->tname; *sp2 != '\0'; sp2++) {
+      *sp2 = tolower((int) *sp2);
+    }
+    nfixstars++;
+    /* data fields */
+    i = swi_cutstr(s, ",", cpos, 20);
+    swi_right_trim(cpos[0]);
+    swi_right_trim(cpos[1]);
+    /* trad. name, nomeclature name */
+    if (strlen(cpos[0]) > SE_MAX_STNAME)
+      cpos[0][SE_MAX_STNAME] = '\0';
+    if (strlen(cpos[1]) > SE_MAX_STNAME-1)
+      cpos[1][SE_MAX_STNAME-1] = '\0';
+    sprintf(fsp->star, "%s,%s", cpos[0], cpos[1]);
+    fsp->ncut = i;
+    if (i < 14)
+      continue;
+    fsp->epoch = atof(cpos[2]);
+    ra_h = atof(cpos[3]);
+    ra_m = atof(cpos[4]);
+    ra_s = atof(cpos[5]);
+    de_d = atof(cpos[6]);
+    de_m = atof(cpos[7]);
+    de_s = atof(cpos[8]);
+    ra_pm = atof(cpos[9]);
+    de_pm = atof(cpos[10]);
+    radv = atof(cpos[11]);
+    parall = atof(cpos[12]);
+    fsp->mag = atof(cpos[13]);
+    /****************************************
+     * position and speed (equinox)
+     ****************************************/
+    /* ra and de in degrees */
+    ra = (ra_s / 3600.0 + ra_m / 60.0 + ra_h) * 15.0;
+    if (de_d >= 0)
+      de = de_s / 3600.0 + de_m / 60.0 + de_d;
+    else
+      de = -de_s / 3600.0 - de_m / 60.0 + de_d;
+    /* speed in ra and de, degrees per century */
+    ra_pm = ra_pm * 15 / 3600.0;
+    de_pm = de_pm / 3600.0;
+    /* parallax, degrees */
+    if (parall > 1)
+      parall = (1 / parall / 3600);
+    else
+      parall /= 3600;
+    /* radial velocity in AU per century */
+    radv *= KM_S_TO_AU_CTY;
+    /* radians */
+    ra *= DEGTORAD;
+    de *= DEGTORAD;
+    ra_pm *= DEGTORAD;
+    de_pm *= DEGTORAD;
+    parall *= DEGTORAD;
+    fsp->parall = parall;
+    x = fsp->x;
+    x[0] = ra;
+    x[1] = de;
+    x[2] = 1;	/* -> unit vector */
+    /* cartesian */
+    swi_polcart(x, x);
+    /*space motion vector */
+    cosra = cos(ra);
+    cosde = cos(de);
+    sinra = sin(ra);
+    sinde = sin(de);
+    x[3] = -ra_pm * cosde * sinra - de_pm * sinde * cosra
+			  + radv * parall * cosde * cosra;
+    x[4] = ra_pm * cosde * cosra - de_pm * sinde * sinra
+			  + radv * parall * cosde * sinra;
+    x[5] = de_pm * cosde + radv * parall * sinde;
+    x[3] /= 36525;
+    x[4] /= 36525;
+    x[5] /= 36525;
+    /******************************************
+     * FK5
+     ******************************************/
+    if (fsp->epoch == 1950) {
+      swi_FK4_FK5(x, B1950);
+      swi_precess(x, B1950, J_TO_J2000);
+      swi_precess(x+3, B1950, J_TO_J2000);
+    } 
+  }
+  fclose(fp);
+  /* index arrays for search by name */
+  n = nfixstars > 0 ? nfixstars : 1;
+  fixstar_tind = (int *) malloc(n * sizeof(int));
+  fixstar_nind = (int *) malloc(n * sizeof(int));
+  if (fixstars == NULL || fixstar_tind == NULL || fixstar_nind == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "error in malloc() with star file %s", SE_STARFILE);
+    free_fixstars();
+    return ERR;
+  }
+  for (i = 0; i < nfixstars; i++)
+    fixstar_tind[i] = fixstar_nind[i] = i;
+  qsort((void *) fixstar_tind, (size_t) nfixstars, sizeof(int), fixstar_tcmp);
+  qsort((void *) fixstar_nind, (size_t) nfixstars, sizeof(int), fixstar_ncmp);
+  return OK;
+}
+
+static void free_fixstars(void)
+{
+  if (fixstars != NULL)
+    free((void *) fixstars);
+  if (fixstar_tind != NULL)
+    free((void *) fixstar_tind);
+  if (fixstar_nind != NULL)
+    free((void *) fixstar_nind);
+  fixstars = NULL;
+  fixstar_tind = fixstar_nind = NULL;
+  nfixstars = 0;
+  fixstar_damaged = -1;
+}
+
+/* returns index of first star in file whose traditional name 
+ * (or nomenclature name, with leading comma) begins with sstar,
+ * or -1. Binary search finds the range of matching names in the
+ * sorted index; the lowest line number within that range wins. */
+static int search_fixstar(char *sstar, size_t cmplen, AS_BOOL isnomclat)
+{
+  int lo = 0, hi = nfixstars, mid, j, istar = -1;
+  int *ind = isnomclat ? fixstar_nind : fixstar_tind;
+  char *sp;
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    sp = isnomclat ? fixstars[ind[mid]].nname : fixstars[ind[mid]].tname;
+    if (strncmp(sp, sstar, cmplen) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  for (j = lo; j < nfixstars; j++) {
+    if (fixstars[ind[j]].ncut <= 1)	/* damaged line, no name */
+      continue;
+    sp = isnomclat ? fixstars[ind[j]].nname : fixstars[ind[j]].tname;
+    if (strncmp(sp, sstar, cmplen) != 0)
+      break;
+    if (istar < 0 || ind[j] < istar)
+      istar = ind[j];
+  }
+  return istar;
+}
+
 #if 0
 int swe_fixstar(char *star, double tjd, long iflag, double *xx, char *serr)
 {
@@ -5266,7 +5960,7 @@ void FAR PASCAL_CONV swe_set_topo(double geolon, double geolat, double geoalt)
     swed.pldat[i].xflgs = -1;
   for (i = 0; i < SEI_NNODE_ETC; i++)
     swed.nddat[i].xflgs = -1;
-  for (i = 0; i < SE_NPLANETS; i++) {
+  for (i = 0; i < SE_NPLANETS + SEI_NASTSAVE; i++) {
     swed.savedat[i].tsave = 0;
     swed.savedat[i].iflgsave = -1;
   }
@@ -181,6 +181,20 @@
 #define SEI_NEPHFILES   7
 #define SEI_CURR_FPOS   -1
 
+/* asteroid files kept open besides the current one, so that charts
+ * with several numbered asteroids do not reopen a file for each body */
+#define SEI_NASTFILES	8
+/* save areas for bodies beyond SE_NPLANETS, hashed by body number;
+ * must be a power of 2 */
+#define SEI_NASTSAVE	64
+
+/* on Unix, ephemeris files are mapped into memory read-only once 
+ * they are opened, and segments are decoded from the mapping.
+ * define NO_MMAP to read them with fseek() and fread() instead. */
+#if HPUNIX && !defined(NO_MMAP)
+#  define SWI_MMAP
+#endif
+
 #define MOSHPLEPH_START	 625000.5
 #define MOSHPLEPH_END  	2818000.5
 #define MOSHLUEPH_START	 625000.5
@@ -248,6 +262,18 @@
 
 #define PLAN_DATA struct plan_data
 
+/* decoded segments kept per planet, besides the current one, so that
+ * alternating between distant dates does not decode them again */
+#define SEI_NSEGCACHE	16	/* maximum */
+#define SEI_NSEGCACHE_DFT 4	/* default, see swe_set_seg_cache() */
+
+struct seg_cache {
+  double tseg0, tseg1;	/* start and end jd of segment, 0 if unused */
+  int neval;		/* how many coefficients to evaluate */
+  long luse;		/* when last used, for least recently used */
+  double *segp;		/* unpacked and rotated cheby coeffs, 3 x ncoe */
+};
+
 /* obliquity of ecliptic */
 struct epsilon {
   double teps, eps, seps, ceps; 	/* jd, eps, sin(eps), cos(eps) */
@@ -291,6 +317,7 @@ struct plan_data {
 			 * the size is 3 x ncoe */
   int neval;		/* how many coefficients to evaluate. this may
 			 * be less than ncoe */
+  struct seg_cache segc[SEI_NSEGCACHE];	/* recently used segments */
   /* result of most recent data evaluation for this body: */
   double teval;		/* time for which previous computation was made */
   long iephe;            /* which ephemeris was used */
@@ -315,11 +342,18 @@ struct plan_data {
 extern int swi_mean_node(double jd, double *x, char *serr);
 extern int swi_mean_apog(double jd, double *x, char *serr);
 extern int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpm, char *serr) ;
+extern int swi_moshmoon_list(double *tjd, int nt, double *xpm, char *serr);
 extern int swi_moshmoon2(double jd, double *x);
+extern int swi_moshmoon2_batch(double *J, int nj, double *x);
 
 /* planets, s. moshplan.c */
 extern int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *xeret, char *serr);
 extern int swi_moshplan2(double J, int iplm, double *pobj);
+/* maximum number of instants for swi_moshplan2_batch() and
+ * swi_moshmoon2_batch(). define NO_MOSH_BATCH to compute 
+ * planets one instant at a time */
+#define MOSH_NBATCH	8
+extern int swi_moshplan2_batch(double *J, int nj, int iplm, double *pobj);
 extern void swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli);
 extern FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr);
 
@@ -348,6 +382,9 @@ struct file_data {
   long sweph_denum;     /* DE number of JPL ephemeris, which this file
 			 * is derived from. */
   FILE *fptr;		/* ephemeris file pointer */
+  unsigned char *mptr;	/* file mapped into memory, or NULL */
+  long mlen;		/* length of mapping */
+  long mpos;		/* current position in mapping */
   double tfstart;       /* file may be used from this date */
   double tfend;         /*      through this date          */
   long iflg; 		/* byte reorder flag and little/bigendian flag */
@@ -355,6 +392,14 @@ struct file_data {
   short ipl[SEI_FILE_NMAXPLAN];	/* planet numbers */
 };
  
+/* an asteroid file and the constants read from it, while another
+ * asteroid is current in fidat[SEI_FILE_ANY_AST] and pldat[SEI_ANYBODY] */
+struct ast_file {
+  long luse;		/* when last used, for least recently used */
+  struct file_data fd;
+  struct plan_data pd;
+};
+
 struct gen_const {
  double clight, 
 	aunit, 
@@ -407,7 +452,8 @@ struct swe_data {
   struct gen_const gcdat;
   struct plan_data pldat[SEI_NPLANETS];
   struct node_data nddat[SEI_NNODE_ETC];
-  struct save_positions savedat[SE_NPLANETS+1];
+  struct save_positions savedat[SE_NPLANETS+SEI_NASTSAVE];
+  struct ast_file astfdat[SEI_NASTFILES];
   struct epsilon oec;
   struct epsilon oec2000;
   struct nut nut;
@@ -322,6 +322,33 @@ ext_def( char *) swe_get_planet_name(int ipl, char *spname);
 /* set geographic position of observer */
 ext_def (void) swe_set_topo(double geolon, double geolat, double geoalt);
 
+/* serve swe_calc() positions from fitted Chebyshev segments, with
+ * the given maximum error in arc seconds; 0 turns the cache off */
+ext_def (void) swe_set_cheb_cache(double maxerr);
+
+/* number of positions served from the cache, and segments fitted */
+ext_def (void) swe_get_cheb_stats(long *nhit, long *nfit);
+
+/* interpolate nutation between evenly spaced nodes, with the given 
+ * maximum error in arc seconds; 0 computes it in full every time */
+ext_def (void) swe_set_nut_cache(double tol);
+
+/* number of nutations computed in full and interpolated, and of 
+ * precessions done with a precession matrix computed before */
+ext_def (void) swe_get_nut_stats(long *nfull, long *ninterp, long *nprec);
+
+/* number of decoded ephemeris file segments kept per planet */
+ext_def (void) swe_set_seg_cache(int nseg);
+
+/* number of segments found among kept ones, and decoded from file,
+ * counting records of a jpl file the same way */
+ext_def (void) swe_get_seg_stats(long *nhit, long *nmiss);
+
+/* number of osculating node and apogee computations served from the
+ * cache of recent dates, and done, and of those done, how many shared
+ * the moon of the date instead of computing it again */
+ext_def (void) swe_get_osc_stats(long *nhit, long *ncalc, long *nshare);
+
 /**************************** 
  * exports from swedate.c 
  ****************************/
@@ -73,6 +73,26 @@ long swi_trace_count = 0;
 
 static double tid_acc = SE_TIDAL_DEFAULT;
 static void init_crc32(void);
+static int calc_nutation(double J, double *nutlo);
+
+/* nutation cache: if a tolerance has been set with swe_set_nut_cache(),
+ * nutation is computed in full only at nodes spaced evenly in time, 
+ * and interpolated by a cubic through the four nodes around J. 
+ * The nodes are kept in a small table indexed by node number. */
+#define NUT_NNODE	8
+struct nut_node {
+  long n;		/* node number, its time is n * nut_step */
+  AS_BOOL ok;
+  double nutlo[2];
+};
+static struct nut_node nut_node[NUT_NNODE];
+static double nut_step = 0;	/* days between nodes, 0 if cache is off */
+static double nut_tol = 0;
+static long nut_nfull = 0, nut_ninterp = 0;
+/* precession matrix from J2000 to the date of the last call of 
+ * swi_precess(), which is used for both directions */
+static double prec_J = 0, prec_m[3][3];
+static long prec_nreuse = 0;
 
 /* Reduce x modulo 360 degrees
  */
@@ -576,35 +596,36 @@ int swi_precess(double *R, double J, int direction )
   Z =  (( 0.017998*T + 0.30188)*T + 2306.2181)*T*DEGTORAD/3600;
   z =  (( 0.018203*T + 1.09468)*T + 2306.2181)*T*DEGTORAD/3600;
   TH = ((-0.041833*T - 0.42665)*T + 2004.3109)*T*DEGTORAD/3600;
-  sinth = sin(TH);
-  costh = cos(TH);
-  sinZ = sin(Z);
-  cosZ = cos(Z);
-  sinz = sin(z);
-  cosz = cos(z);
-  A = cosZ*costh;
-  B = sinZ*costh;
+  /* the same date is usually precessed several times in a row, e.g. 
+   * position and speed, so the matrix is kept for the next call */
+  if (J != prec_J) {
+    sinth = sin(TH);
+    costh = cos(TH);
+    sinZ = sin(Z);
+    cosZ = cos(Z);
+    sinz = sin(z);
+    cosz = cos(z);
+    A = cosZ*costh;
+    B = sinZ*costh;
+    prec_m[0][0] =   A*cosz - sinZ*sinz;
+    prec_m[0][1] = -(B*cosz + cosZ*sinz);
+    prec_m[0][2] = - sinth*cosz;
+    prec_m[1][0] =   A*sinz + sinZ*cosz;
+    prec_m[1][1] = -(B*sinz - cosZ*cosz);
+    prec_m[1][2] = - sinth*sinz;
+    prec_m[2][0] =   cosZ*sinth;
+    prec_m[2][1] = - sinZ*sinth;
+    prec_m[2][2] =   costh;
+    prec_J = J;
+  } else
+    prec_nreuse++;
   if( direction < 0 ) { /* From J2000.0 to J */
-    x[0] =    (A*cosz - sinZ*sinz)*R[0]
-	    - (B*cosz + cosZ*sinz)*R[1]
-		      - sinth*cosz*R[2];
-    x[1] =    (A*sinz + sinZ*cosz)*R[0]
-	    - (B*sinz - cosZ*cosz)*R[1]
-		      - sinth*sinz*R[2];
-    x[2] =              cosZ*sinth*R[0]
-		      - sinZ*sinth*R[1]
-		      + costh*R[2];
+    for (i = 0; i < 3; i++)
+      x[i] = prec_m[i][0]*R[0] + prec_m[i][1]*R[1] + prec_m[i][2]*R[2];
   }
   else { /* From J to J2000.0 */
-    x[0] =    (A*cosz - sinZ*sinz)*R[0]
-	    + (A*sinz + sinZ*cosz)*R[1]
-		      + cosZ*sinth*R[2];
-    x[1] =  - (B*cosz + cosZ*sinz)*R[0]
-	    - (B*sinz - cosZ*cosz)*R[1]
-		      - sinZ*sinth*R[2];
-    x[2] =            - sinth*cosz*R[0]
-		      - sinth*sinz*R[1]
-                      + costh*R[2];
+    for (i = 0; i < 3; i++)
+      x[i] = prec_m[0][i]*R[0] + prec_m[1][i]*R[1] + prec_m[2][i]*R[2];
   }	
   goto done;
   laskar:
@@ -871,7 +892,68 @@ static short FAR nt[] = {
  ENDMARK,
 };
 
+/* sets the maximum error of interpolated nutation, in arc seconds.
+ * The error of the cubic is about 6e-4" times the fourth power of the
+ * node spacing in days, mostly from the 13.66 day term; the spacing 
+ * is kept below 8 days. 0 turns interpolation off. */
+void FAR PASCAL_CONV swe_set_nut_cache(double tol)
+{
+  if (tol < 0)
+    tol = 0;
+  if (tol == nut_tol)
+    return;
+  nut_tol = tol;
+  nut_step = tol > 0 ? pow(tol / 6e-4, 0.25) : 0;
+  if (nut_step > 8)
+    nut_step = 8;
+  memset((void *) nut_node, 0, sizeof(nut_node));
+}
+
+void FAR PASCAL_CONV swe_get_nut_stats(long *nfull, long *ninterp, long *nprec)
+{
+  *nfull = nut_nfull;
+  *ninterp = nut_ninterp;
+  *nprec = prec_nreuse;
+}
+
+/* Nutation at J, interpolated between nodes if swe_set_nut_cache() 
+ * has been called, otherwise computed by calc_nutation().
+ */
 int swi_nutation(double J, double *nutlo)
+{
+  int i, k;
+  long n;
+  double u, w[4];
+  struct nut_node *np;
+  if (nut_step <= 0) {
+    nut_nfull++;
+    return calc_nutation(J, nutlo);
+  }
+  u = J / nut_step;
+  n = (long) floor(u);
+  u -= n;
+  /* Lagrange weights of nodes n-1 .. n+2 */
+  w[0] = -u * (u - 1) * (u - 2) / 6;
+  w[1] = (u + 1) * (u - 1) * (u - 2) / 2;
+  w[2] = -(u + 1) * u * (u - 2) / 2;
+  w[3] = (u + 1) * u * (u - 1) / 6;
+  nutlo[0] = nutlo[1] = 0;
+  for (i = 0; i < 4; i++) {
+    np = &nut_node[((n - 1 + i) % NUT_NNODE + NUT_NNODE) % NUT_NNODE];
+    if (!np->ok || np->n != n - 1 + i) {
+      np->n = n - 1 + i;
+      calc_nutation(np->n * nut_step, np->nutlo);
+      np->ok = TRUE;
+      nut_nfull++;
+    }
+    for (k = 0; k < 2; k++)
+      nutlo[k] += w[i] * np->nutlo[k];
+  }
+  nut_ninterp++;
+  return(0);
+}
+
+static int calc_nutation(double J, double *nutlo)
 {
   /* arrays to hold sines and cosines of multiple angles */
   double ss[5][8];
@@ -1133,70 +1215,22 @@ static short FAR dt[TABSIZ] = {
  6300, 6400, 6500
 };
 
-/* returns DeltaT (ET - UT) in days
- * double tjd 	= 	julian day in UT
+/* Besselian interpolation from tabulated values.
+ * See AA page K11.
+ * iy is the index into the table, p the fraction of the tabulation
+ * interval. returns DeltaT in units of the table, 0.01 sec.
  */
-double FAR PASCAL_CONV swe_deltat(double tjd)
+static double deltat_bessel(int iy, double p)
 {
-  double ans;
-  double p, B, Y;
+  double ans, B;
   int d[6];
-  int i, iy, k;
-  Y = 2000.0 + (tjd - J2000)/365.25;
-  if( Y > TABEND ) {
-#if 0
-    /* Morrison, L. V. and F. R. Stephenson, "Sun and Planetary System"
-     * vol 96,73 eds. W. Fricke, G. Teleki, Reidel, Dordrecht (1982)
-     */
-    B = 0.01*(Y-1800.0) - 0.1;
-    ans = -15.0 + 32.5*B*B;
-    ans /= 86400;
-    goto return_ans;
-#else
-    /* Extrapolate forward by a second-degree curve that agrees with
-     * the most recent data in value and slope, and vaguely fits
-     * over the past century.  This idea communicated by Paul Muller,
-     * who says NASA used to do something like it.  */
-    B = Y - 1902.0;
-    ans = (0.00362 * B + 0.319) * B + 0.0;
-#if DEMO 
-    printf("[extrapolated deltaT] ");
-#endif
-    ans /= 86400;
-    goto return_ans;
-#endif
-  }
-  if( Y < TABSTART ) {
-    if( Y >= 948.0 ) {
-      /* Stephenson and Morrison, stated domain is 948 to 1600:
-       * 25.5(centuries from 1800)^2 - 1.9159(centuries from 1955)^2
-       */
-      B = 0.01*(Y - 2000.0);
-      ans = (23.58 * B + 100.3)*B + 101.6;
-    } else {
-      /* Borkowski */
-      B = 0.01*(Y - 2000.0)  +  3.75;
-      ans = 35.0 * B * B  +  40.;
-    }
-    ans /= 86400;
-    goto return_ans;
-  }
-  /* Besselian interpolation from tabulated values.
-   * See AA page K11.
-   */
-  /* Index into the table.
-   */
-  p = floor(Y);
-  iy = (int) (p - TABSTART);
+  int i, k;
   /* Zeroth order estimate is value at start of year
    */
   ans = dt[iy];
   k = iy + 1;
   if( k >= TABSIZ )
     goto done; /* No data, can't go on. */
-  /* The fraction of tabulation interval
-   */
-  p = Y - p;
   /* First order interpolated value
    */
   ans += p*(dt[k] - dt[iy]);
@@ -1244,6 +1278,113 @@ double FAR PASCAL_CONV swe_deltat(double tjd)
   printf( "B %.4lf, ans %.4lf\n", B, ans );
 #endif
   done:
+  return ans;
+}
+
+/* Within each year of the table, the Besselian interpolation is a
+ * polynomial of 4th degree in the fraction of the year. Its coefficients
+ * are found once from five values of the interpolation, so that DeltaT
+ * is then evaluated by Horner's rule. Each polynomial is checked against
+ * the interpolation at other points; if one disagrees, the table is not
+ * used and swe_deltat() interpolates as before.
+ */
+static double FAR dtcoef[TABSIZ][5];
+static int dtcoef_init = 0;	/* 0 not built, 1 in use, -1 not in use */
+
+static void init_dtcoef(void)
+{
+  int i, j, iy;
+  double f[5], *c, p, x;
+  dtcoef_init = 1;
+  for (iy = 0; iy < TABSIZ; iy++) {
+    /* forward differences of values at p = 0, 1/4, 1/2, 3/4, 1 */
+    for (i = 0; i < 5; i++)
+      f[i] = deltat_bessel(iy, i * 0.25);
+    for (i = 1; i < 5; i++)
+      for (j = 4; j >= i; j--)
+	f[j] -= f[j-1];
+    /* Newton's forward formula expanded in powers of s = 4p */
+    c = dtcoef[iy];
+    c[0] = f[0];
+    c[1] = (f[1] - f[2] / 2 + f[3] / 3 - f[4] / 4) * 4;
+    c[2] = (f[2] / 2 - f[3] / 2 + f[4] * 11 / 24) * 16;
+    c[3] = (f[3] / 6 - f[4] / 4) * 64;
+    c[4] = f[4] / 24 * 256;
+    for (i = 0; i < 4; i++) {
+      p = 0.1 + i * 0.27;
+      x = (((c[4] * p + c[3]) * p + c[2]) * p + c[1]) * p + c[0];
+      if (fabs(x - deltat_bessel(iy, p)) > 1e-6) {
+	dtcoef_init = -1;
+	return;
+      }
+    }
+  }
+}
+
+/* returns DeltaT (ET - UT) in days
+ * double tjd 	= 	julian day in UT
+ */
+double FAR PASCAL_CONV swe_deltat(double tjd)
+{
+  double ans;
+  double p, B, Y, *c;
+  int iy;
+  Y = 2000.0 + (tjd - J2000)/365.25;
+  if( Y > TABEND ) {
+#if 0
+    /* Morrison, L. V. and F. R. Stephenson, "Sun and Planetary System"
+     * vol 96,73 eds. W. Fricke, G. Teleki, Reidel, Dordrecht (1982)
+     */
+    B = 0.01*(Y-1800.0) - 0.1;
+    ans = -15.0 + 32.5*B*B;
+    ans /= 86400;
+    goto return_ans;
+#else
+    /* Extrapolate forward by a second-degree curve that agrees with
+     * the most recent data in value and slope, and vaguely fits
+     * over the past century.  This idea communicated by Paul Muller,
+     * who says NASA used to do something like it.  */
+    B = Y - 1902.0;
+    ans = (0.00362 * B + 0.319) * B + 0.0;
+#if DEMO 
+    printf("[extrapolated deltaT] ");
+#endif
+    ans /= 86400;
+    goto return_ans;
+#endif
+  }
+  if( Y < TABSTART ) {
+    if( Y >= 948.0 ) {
+      /* Stephenson and Morrison, stated domain is 948 to 1600:
+       * 25.5(centuries from 1800)^2 - 1.9159(centuries from 1955)^2
+       */
+      B = 0.01*(Y - 2000.0);
+      ans = (23.58 * B + 100.3)*B + 101.6;
+    } else {
+      /* Borkowski */
+      B = 0.01*(Y - 2000.0)  +  3.75;
+      ans = 35.0 * B * B  +  40.;
+    }
+    ans /= 86400;
+    goto return_ans;
+  }
+  /* Interpolation from tabulated values, see deltat_bessel().
+   */
+  /* Index into the table.
+   */
+  p = floor(Y);
+  iy = (int) (p - TABSTART);
+  /* The fraction of tabulation interval
+   */
+  p = Y - p;
+  if (dtcoef_init == 0)
+    init_dtcoef();
+  if (dtcoef_init > 0) {
+    c = dtcoef[iy];
+    ans = (((c[4] * p + c[3]) * p + c[2]) * p + c[1]) * p + c[0];
+  } else {
+    ans = deltat_bessel(iy, p);
+  }
   /* Astronomical Almanac table is corrected by adding the expression
    *     -0.000091 (ndot + 26)(year-1955)^2  seconds
    * to entries prior to 1955 (AA page K8), where ndot is the secular
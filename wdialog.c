@@ -1173,6 +1173,7 @@ LONG lParam;
         if (GetCheck(dxa01 - 1 + i))
           rAspOrb[i] = -rDegHalf;
       }
+      InvalidateOrbs();
       wi.fRedraw = fTrue;
     }
     if (wParam == IDOK || wParam == IDCANCEL) {
@@ -1229,6 +1230,7 @@ LONG lParam;
             rObjInf[i] = r;
         }
       }
+      InvalidateOrbs();
       wi.fRedraw = fTrue;
     }
     if (wParam == IDOK || wParam == IDCANCEL) {
@@ -1285,6 +1287,7 @@ LONG lParam;
             rObjInf[i] = r;
         }
       }
+      InvalidateOrbs();
       wi.fRedraw = fTrue;
     }
     if (wParam == IDOK || wParam == IDCANCEL) {
@@ -1910,6 +1913,7 @@ LONG lParam;
       PartOrb = r1;
       StarOrb = r2;
       CoeffTens = r3;
+      InvalidateOrbs();
       if (GetCheck(dr11)) TensChart = 0;
       if (GetCheck(dr12)) TensChart = 1;
       if (GetCheck(dr13)) TensChart = -1;
@@ -448,10 +448,15 @@ int mode, toadd;
       ciMain = ciCore;
     if (us.fProgress && !us.nRel)
       ciCore = ciT;
+
+    /* Frames shown only briefly may use cheaper formulas, see -Ya. */
+
+    is.fCoarse = us.rEphTier > 0.0;
     if (us.nRel)
       CastRelation();
     else
       CastChart(fTrue);
+    is.fCoarse = fFalse;
   }
 }
 